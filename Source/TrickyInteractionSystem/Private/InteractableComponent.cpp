@@ -0,0 +1,97 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractableComponent.h"
+
+#include "TrickyInteractionSubsystem.h"
+#include "Engine/World.h"
+
+UInteractableComponent::UInteractableComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UInteractableComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	// Registered before BeginPlay, so the owner is already interactive when the subsystem handles its spawn
+	const UWorld* World = GetWorld();
+
+	if (UTrickyInteractionSubsystem* Subsystem = World ? World->GetSubsystem<UTrickyInteractionSubsystem>() : nullptr)
+	{
+		Subsystem->RegisterInteractableComponent(this);
+	}
+}
+
+void UInteractableComponent::OnUnregister()
+{
+	const UWorld* World = GetWorld();
+
+	if (UTrickyInteractionSubsystem* Subsystem = World ? World->GetSubsystem<UTrickyInteractionSubsystem>() : nullptr)
+	{
+		Subsystem->UnregisterInteractableComponent(this);
+	}
+
+	Super::OnUnregister();
+}
+
+EInteractionResult UInteractableComponent::StartInteraction(AActor* Interactor) const
+{
+	if (StartInteractionHandler.IsBound())
+	{
+		return StartInteractionHandler.Execute(Interactor);
+	}
+
+	AActor* Owner = GetOwner();
+	return IsValid(Owner) && Owner->Implements<UTrickyInteractionInterface>()
+		       ? ITrickyInteractionInterface::Execute_StartInteraction(Owner, Interactor)
+		       : EInteractionResult::Invalid;
+}
+
+EInteractionResult UInteractableComponent::InterruptInteraction(AActor* Interruptor, AActor* Interactor) const
+{
+	if (InterruptInteractionHandler.IsBound())
+	{
+		return InterruptInteractionHandler.Execute(Interruptor, Interactor);
+	}
+
+	AActor* Owner = GetOwner();
+	return IsValid(Owner) && Owner->Implements<UTrickyInteractionInterface>()
+		       ? ITrickyInteractionInterface::Execute_InterruptInteraction(Owner, Interruptor, Interactor)
+		       : EInteractionResult::Invalid;
+}
+
+EInteractionResult UInteractableComponent::FinishInteraction(AActor* Interactor) const
+{
+	if (FinishInteractionHandler.IsBound())
+	{
+		return FinishInteractionHandler.Execute(Interactor);
+	}
+
+	AActor* Owner = GetOwner();
+	return IsValid(Owner) && Owner->Implements<UTrickyInteractionInterface>()
+		       ? ITrickyInteractionInterface::Execute_FinishInteraction(Owner, Interactor)
+		       : EInteractionResult::Invalid;
+}
+
+EInteractionResult UInteractableComponent::ForceInteraction(AActor* Interactor) const
+{
+	if (ForceInteractionHandler.IsBound())
+	{
+		return ForceInteractionHandler.Execute(Interactor);
+	}
+
+	AActor* Owner = GetOwner();
+	return IsValid(Owner) && Owner->Implements<UTrickyInteractionInterface>()
+		       ? ITrickyInteractionInterface::Execute_ForceInteraction(Owner, Interactor)
+		       : EInteractionResult::Invalid;
+}
+
+void UInteractableComponent::UnbindInteractionHandlers()
+{
+	StartInteractionHandler.Unbind();
+	InterruptInteractionHandler.Unbind();
+	FinishInteractionHandler.Unbind();
+	ForceInteractionHandler.Unbind();
+}
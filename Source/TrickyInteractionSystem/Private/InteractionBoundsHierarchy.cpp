@@ -0,0 +1,408 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractionBoundsHierarchy.h"
+
+#include "GameFramework/Actor.h"
+
+void FInteractionBoundsHierarchy::AddActor(AActor* Actor)
+{
+	if (!IsValid(Actor) || EntryIndices.Contains(Actor))
+	{
+		return;
+	}
+
+	FEntry Entry;
+	Entry.Actor = Actor;
+	Entry.Key = Actor;
+	Entry.Bounds = GetActorBounds(Actor);
+	Entry.bIsMovable = Actor->IsRootComponentMovable();
+
+	const int32 EntryIndex = Entries.Add(Entry);
+	EntryIndices.Add(Actor, EntryIndex);
+	InsertLeaf(EntryIndex);
+}
+
+void FInteractionBoundsHierarchy::RemoveActor(const AActor* Actor)
+{
+	int32 EntryIndex = INDEX_NONE;
+
+	if (!EntryIndices.RemoveAndCopyValue(Actor, EntryIndex))
+	{
+		return;
+	}
+
+	RemoveEntry(EntryIndex);
+}
+
+void FInteractionBoundsHierarchy::Reset()
+{
+	Entries.Reset();
+	EntryIndices.Reset();
+	Nodes.Reset();
+	Root = INDEX_NONE;
+	FreeNode = INDEX_NONE;
+}
+
+void FInteractionBoundsHierarchy::Update()
+{
+	// Removal swaps the last entry in, so iterating backwards visits every entry once
+	for (int32 EntryIndex = Entries.Num() - 1; EntryIndex >= 0; --EntryIndex)
+	{
+		FEntry& Entry = Entries[EntryIndex];
+		const AActor* Actor = Entry.Actor.Get();
+
+		// Actors destroyed without being removed are dropped here
+		if (!Actor)
+		{
+			EntryIndices.Remove(Entry.Key);
+			RemoveEntry(EntryIndex);
+			continue;
+		}
+
+		if (!Entry.bIsMovable)
+		{
+			continue;
+		}
+
+		const FBox NewBounds = GetActorBounds(Actor);
+
+		if (NewBounds.Equals(Entry.Bounds))
+		{
+			continue;
+		}
+
+		Entry.Bounds = NewBounds;
+
+		if (NewBounds.IsValid && Nodes[Entry.Leaf].Bounds.IsInside(NewBounds))
+		{
+			continue;
+		}
+
+		RemoveLeaf(Entry.Leaf);
+		InsertLeaf(EntryIndex);
+	}
+}
+
+AActor* FInteractionBoundsHierarchy::Raycast(const FVector& Start,
+                                             const FVector& End,
+                                             const float Radius,
+                                             TConstArrayView<AActor*> ActorsToIgnore,
+                                             FVector& OutHitLocation) const
+{
+	FVector Direction = End - Start;
+	const double Length = Direction.Size();
+
+	if (Root == INDEX_NONE || Length <= UE_KINDA_SMALL_NUMBER)
+	{
+		return nullptr;
+	}
+
+	Direction /= Length;
+
+	FVector InverseDirection;
+
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		InverseDirection[Axis] = FMath::Abs(Direction[Axis]) > UE_SMALL_NUMBER
+			                         ? 1.0 / Direction[Axis]
+			                         : UE_BIG_NUMBER;
+	}
+
+	double BestDistance = Length;
+	AActor* BestActor = nullptr;
+	TArray<int32, TInlineAllocator<64>> Stack;
+	Stack.Push(Root);
+
+	while (!Stack.IsEmpty())
+	{
+		const FNode& Node = Nodes[Stack.Pop(EAllowShrinking::No)];
+		double NodeDistance = 0.0;
+
+		if (!IntersectRay(Node.Bounds, Radius, Start, InverseDirection, BestDistance, NodeDistance))
+		{
+			continue;
+		}
+
+		if (!Node.IsLeaf())
+		{
+			Stack.Push(Node.Children[0]);
+			Stack.Push(Node.Children[1]);
+			continue;
+		}
+
+		const FEntry& Entry = Entries[Node.Entry];
+		AActor* Actor = Entry.Actor.Get();
+		double EntryDistance = 0.0;
+
+		if (!Actor
+			|| ActorsToIgnore.Contains(Actor)
+			|| !IntersectRay(Entry.Bounds, Radius, Start, InverseDirection, BestDistance, EntryDistance))
+		{
+			continue;
+		}
+
+		BestDistance = EntryDistance;
+		BestActor = Actor;
+	}
+
+	OutHitLocation = Start + Direction * BestDistance;
+	return BestActor;
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+bool FInteractionBoundsHierarchy::IsTreeValid() const
+{
+	if (Root == INDEX_NONE)
+	{
+		return Entries.IsEmpty();
+	}
+
+	if (Nodes[Root].Parent != INDEX_NONE)
+	{
+		return false;
+	}
+
+	int32 LeavesNum = 0;
+	TArray<int32, TInlineAllocator<64>> Stack;
+	Stack.Push(Root);
+
+	while (!Stack.IsEmpty())
+	{
+		const int32 NodeIndex = Stack.Pop(EAllowShrinking::No);
+		const FNode& Node = Nodes[NodeIndex];
+
+		if (Node.IsLeaf())
+		{
+			++LeavesNum;
+
+			if (!Entries.IsValidIndex(Node.Entry) || Entries[Node.Entry].Leaf != NodeIndex)
+			{
+				return false;
+			}
+
+			const FBox& EntryBounds = Entries[Node.Entry].Bounds;
+
+			if (EntryBounds.IsValid && !Node.Bounds.IsInsideOrOn(EntryBounds))
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		for (const int32 Child : Node.Children)
+		{
+			if (!Nodes.IsValidIndex(Child) || Nodes[Child].Parent != NodeIndex)
+			{
+				return false;
+			}
+
+			if (Nodes[Child].Bounds.IsValid && !Node.Bounds.IsInsideOrOn(Nodes[Child].Bounds))
+			{
+				return false;
+			}
+
+			Stack.Push(Child);
+		}
+	}
+
+	return LeavesNum == Entries.Num() && EntryIndices.Num() == Entries.Num();
+}
+#endif
+
+int32 FInteractionBoundsHierarchy::AllocateNode()
+{
+	if (FreeNode == INDEX_NONE)
+	{
+		return Nodes.AddDefaulted();
+	}
+
+	const int32 NodeIndex = FreeNode;
+	FreeNode = Nodes[NodeIndex].Parent;
+	Nodes[NodeIndex] = FNode();
+	return NodeIndex;
+}
+
+void FInteractionBoundsHierarchy::ReleaseNode(const int32 NodeIndex)
+{
+	Nodes[NodeIndex] = FNode();
+	Nodes[NodeIndex].Parent = FreeNode;
+	FreeNode = NodeIndex;
+}
+
+void FInteractionBoundsHierarchy::InsertLeaf(const int32 EntryIndex)
+{
+	const int32 Leaf = AllocateNode();
+	const FEntry& Entry = Entries[EntryIndex];
+	const FBox LeafBounds = Entry.bIsMovable && Entry.Bounds.IsValid
+		                        ? Entry.Bounds.ExpandBy(MovableBoundsMargin)
+		                        : Entry.Bounds;
+	Nodes[Leaf].Bounds = LeafBounds;
+	Nodes[Leaf].Entry = EntryIndex;
+	Entries[EntryIndex].Leaf = Leaf;
+
+	if (Root == INDEX_NONE)
+	{
+		Root = Leaf;
+		return;
+	}
+
+	// Descend to the sibling which minimizes the growth of the surface area of the tree
+	int32 Sibling = Root;
+
+	while (!Nodes[Sibling].IsLeaf())
+	{
+		const FNode& Node = Nodes[Sibling];
+		const double CombinedArea = GetSurfaceArea(Node.Bounds + LeafBounds);
+		const double SiblingCost = 2.0 * CombinedArea;
+		const double InheritanceCost = 2.0 * (CombinedArea - GetSurfaceArea(Node.Bounds));
+
+		auto GetDescendCost = [this, &LeafBounds, InheritanceCost](const int32 Child)
+		{
+			const FBox& ChildBounds = Nodes[Child].Bounds;
+			const double ChildArea = GetSurfaceArea(ChildBounds + LeafBounds);
+			return Nodes[Child].IsLeaf()
+				       ? ChildArea + InheritanceCost
+				       : ChildArea - GetSurfaceArea(ChildBounds) + InheritanceCost;
+		};
+
+		const double FirstCost = GetDescendCost(Node.Children[0]);
+		const double SecondCost = GetDescendCost(Node.Children[1]);
+
+		if (SiblingCost < FirstCost && SiblingCost < SecondCost)
+		{
+			break;
+		}
+
+		Sibling = FirstCost < SecondCost ? Node.Children[0] : Node.Children[1];
+	}
+
+	const int32 OldParent = Nodes[Sibling].Parent;
+	const int32 NewParent = AllocateNode();
+	Nodes[NewParent].Parent = OldParent;
+	Nodes[NewParent].Children[0] = Sibling;
+	Nodes[NewParent].Children[1] = Leaf;
+	Nodes[NewParent].Bounds = Nodes[Sibling].Bounds + LeafBounds;
+	Nodes[Sibling].Parent = NewParent;
+	Nodes[Leaf].Parent = NewParent;
+
+	if (OldParent == INDEX_NONE)
+	{
+		Root = NewParent;
+		return;
+	}
+
+	FNode& Parent = Nodes[OldParent];
+	Parent.Children[Parent.Children[0] == Sibling ? 0 : 1] = NewParent;
+	RefitAncestors(OldParent);
+}
+
+void FInteractionBoundsHierarchy::RemoveLeaf(const int32 Leaf)
+{
+	const int32 Parent = Nodes[Leaf].Parent;
+	ReleaseNode(Leaf);
+
+	if (Parent == INDEX_NONE)
+	{
+		Root = INDEX_NONE;
+		return;
+	}
+
+	// The sibling takes the place of the parent
+	const int32 GrandParent = Nodes[Parent].Parent;
+	const int32 Sibling = Nodes[Parent].Children[0] == Leaf ? Nodes[Parent].Children[1] : Nodes[Parent].Children[0];
+	ReleaseNode(Parent);
+	Nodes[Sibling].Parent = GrandParent;
+
+	if (GrandParent == INDEX_NONE)
+	{
+		Root = Sibling;
+		return;
+	}
+
+	FNode& GrandParentNode = Nodes[GrandParent];
+	GrandParentNode.Children[GrandParentNode.Children[0] == Parent ? 0 : 1] = Sibling;
+	RefitAncestors(GrandParent);
+}
+
+void FInteractionBoundsHierarchy::RemoveEntry(const int32 EntryIndex)
+{
+	RemoveLeaf(Entries[EntryIndex].Leaf);
+	Entries.RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+
+	if (!Entries.IsValidIndex(EntryIndex))
+	{
+		return;
+	}
+
+	const FEntry& MovedEntry = Entries[EntryIndex];
+	Nodes[MovedEntry.Leaf].Entry = EntryIndex;
+	EntryIndices.FindChecked(MovedEntry.Key) = EntryIndex;
+}
+
+void FInteractionBoundsHierarchy::RefitAncestors(int32 NodeIndex)
+{
+	while (NodeIndex != INDEX_NONE)
+	{
+		FNode& Node = Nodes[NodeIndex];
+		Node.Bounds = Nodes[Node.Children[0]].Bounds + Nodes[Node.Children[1]].Bounds;
+		NodeIndex = Node.Parent;
+	}
+}
+
+double FInteractionBoundsHierarchy::GetSurfaceArea(const FBox& Bounds)
+{
+	if (!Bounds.IsValid)
+	{
+		return 0.0;
+	}
+
+	const FVector Size = Bounds.GetSize();
+	return 2.0 * (Size.X * Size.Y + Size.Y * Size.Z + Size.Z * Size.X);
+}
+
+FBox FInteractionBoundsHierarchy::GetActorBounds(const AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return FBox(ForceInit);
+	}
+
+	const FBox CollidingBounds = Actor->GetComponentsBoundingBox();
+	return CollidingBounds.IsValid ? CollidingBounds : Actor->GetComponentsBoundingBox(true);
+}
+
+bool FInteractionBoundsHierarchy::IntersectRay(const FBox& Bounds,
+                                               const double Radius,
+                                               const FVector& Origin,
+                                               const FVector& InverseDirection,
+                                               const double MaxDistance,
+                                               double& OutDistance)
+{
+	if (!Bounds.IsValid)
+	{
+		return false;
+	}
+
+	const FBox Box = Bounds.ExpandBy(Radius);
+
+	double MinDistance = 0.0;
+	double MaxSlabDistance = MaxDistance;
+
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		const double DistanceA = (Box.Min[Axis] - Origin[Axis]) * InverseDirection[Axis];
+		const double DistanceB = (Box.Max[Axis] - Origin[Axis]) * InverseDirection[Axis];
+		MinDistance = FMath::Max(MinDistance, FMath::Min(DistanceA, DistanceB));
+		MaxSlabDistance = FMath::Min(MaxSlabDistance, FMath::Max(DistanceA, DistanceB));
+
+		if (MinDistance > MaxSlabDistance)
+		{
+			return false;
+		}
+	}
+
+	OutDistance = MinDistance;
+	return true;
+}
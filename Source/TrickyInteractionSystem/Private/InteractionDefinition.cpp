@@ -0,0 +1,171 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractionDefinition.h"
+
+#include "EngineUtils.h"
+#include "TrickyInteractionLibrary.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+
+void UInteractionDataOverrides::ApplyTo(FInteractionData& InteractionData) const
+{
+	if (bOverrideInteractionMessage)
+	{
+		InteractionData.InteractionMessage = InteractionMessage;
+	}
+
+	if (bOverrideRequiresLineOfSight)
+	{
+		InteractionData.bRequiresLineOfSight = bRequiresLineOfSight;
+	}
+
+	if (bOverrideInteractionWeight)
+	{
+		InteractionData.InteractionWeight = InteractionWeight;
+	}
+
+	if (bOverrideInteractionDuration)
+	{
+		InteractionData.InteractionDuration = InteractionDuration;
+	}
+
+	if (bOverrideMaxInteractors)
+	{
+		InteractionData.MaxInteractors = MaxInteractors;
+	}
+}
+
+const FInteractionData& UInteractionDataOverrides::GetMergedData(const UInteractionDefinition* Definition) const
+{
+	const FInteractionData& DefinitionData = Definition->GetInteractionData();
+
+	if (!IsMergedDataCurrent(DefinitionData))
+	{
+		MergedData.Emplace(DefinitionData);
+		ApplyTo(MergedData.GetValue());
+	}
+
+	return MergedData.GetValue();
+}
+
+bool UInteractionDataOverrides::IsMergedDataCurrent(const FInteractionData& DefinitionData) const
+{
+	if (!MergedData.IsSet())
+	{
+		return false;
+	}
+
+	const FInteractionData& Data = MergedData.GetValue();
+
+	return Data.InteractionMessage.IdenticalTo(bOverrideInteractionMessage
+		                                           ? InteractionMessage
+		                                           : DefinitionData.InteractionMessage)
+		&& Data.bRequiresLineOfSight == (bOverrideRequiresLineOfSight
+			                                 ? bRequiresLineOfSight
+			                                 : DefinitionData.bRequiresLineOfSight)
+		&& Data.InteractionWeight == (bOverrideInteractionWeight ? InteractionWeight : DefinitionData.InteractionWeight)
+		&& Data.InteractionDuration == (bOverrideInteractionDuration
+			                                ? InteractionDuration
+			                                : DefinitionData.InteractionDuration)
+		&& Data.MaxInteractors == (bOverrideMaxInteractors ? MaxInteractors : DefinitionData.MaxInteractors)
+		&& Data.InteractionAssets == DefinitionData.InteractionAssets;
+}
+
+#if !UE_BUILD_SHIPPING
+static void PrintInteractionMemoryReport(UWorld* World)
+{
+	if (!IsValid(World))
+	{
+		return;
+	}
+
+	int32 InteractiveActorsNum = 0;
+	int32 DefinitionActorsNum = 0;
+	int32 OverridesNum = 0;
+	int64 InstanceBytes = 0;
+	int64 InlineBytes = 0;
+	int64 DefinitionInstanceBytes = 0;
+	TSet<const UInteractionDefinition*> Definitions;
+
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		AActor* Actor = *It;
+
+		if (!UTrickyInteractionLibrary::IsActorInteractive(Actor))
+		{
+			continue;
+		}
+
+		++InteractiveActorsNum;
+
+		const FInteractionDataProperties& Properties = UTrickyInteractionLibrary::FindInteractionDataProperties(
+			Actor->GetClass());
+		const FStructProperty* DataProperty = Properties.DataProperty;
+		const FObjectProperty* DefinitionProperty = Properties.DefinitionProperty;
+		const FObjectProperty* OverridesProperty = Properties.OverridesProperty;
+
+		int64 ActorBytes = 0;
+
+		ActorBytes += DataProperty ? DataProperty->GetSize() : 0;
+
+		ActorBytes += DefinitionProperty ? DefinitionProperty->GetSize() : 0;
+		ActorBytes += OverridesProperty ? OverridesProperty->GetSize() : 0;
+
+		const UInteractionDataOverrides* Overrides = OverridesProperty
+			                                             ? Cast<UInteractionDataOverrides>(
+				                                             OverridesProperty->GetObjectPropertyValue_InContainer(Actor))
+			                                             : nullptr;
+
+		if (Overrides)
+		{
+			++OverridesNum;
+			ActorBytes += Overrides->GetClass()->GetStructureSize();
+		}
+
+		InstanceBytes += ActorBytes;
+
+		const UInteractionDefinition* Definition = DefinitionProperty
+			                                           ? Cast<UInteractionDefinition>(
+				                                           DefinitionProperty->GetObjectPropertyValue_InContainer(Actor))
+			                                           : nullptr;
+
+		if (!Definition)
+		{
+			continue;
+		}
+
+		++DefinitionActorsNum;
+		Definitions.Add(Definition);
+		DefinitionInstanceBytes += ActorBytes;
+
+		// Without definitions every one of these actors would carry its own copy of the interaction data
+		InlineBytes += sizeof(FInteractionData);
+	}
+
+	int64 DefinitionBytes = 0;
+
+	for (const UInteractionDefinition* Definition : Definitions)
+	{
+		DefinitionBytes += Definition->GetClass()->GetStructureSize()
+			+ Definition->GetInteractionData().InteractionAssets.GetAllocatedSize();
+	}
+
+	UE_LOG(LogTrickyInteractionSystem, Display, TEXT("Interaction memory report for %s"), *World->GetName());
+	UE_LOG(LogTrickyInteractionSystem, Display, TEXT("  Interactive actors: %d (%d use definitions, %d with overrides)"),
+	       InteractiveActorsNum, DefinitionActorsNum, OverridesNum);
+	UE_LOG(LogTrickyInteractionSystem, Display, TEXT("  Unique definitions: %d (%lld bytes)"),
+	       Definitions.Num(), DefinitionBytes);
+	UE_LOG(LogTrickyInteractionSystem, Display, TEXT("  Per-instance interaction bytes: %lld"), InstanceBytes);
+	UE_LOG(LogTrickyInteractionSystem, Display, TEXT("  Definition actors: %lld bytes, %lld bytes with inline data"),
+	       DefinitionInstanceBytes, InlineBytes);
+	UE_LOG(LogTrickyInteractionSystem, Display, TEXT("  Bytes saved by definitions: %lld"),
+	       InlineBytes - DefinitionInstanceBytes - DefinitionBytes);
+}
+
+static FAutoConsoleCommandWithWorld InteractionMemoryReportCommand(
+	TEXT("TrickyInteraction.MemoryReport"),
+	TEXT("Prints per-instance interaction data memory and the bytes saved by shared interaction definitions."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&PrintInteractionMemoryReport));
+#endif
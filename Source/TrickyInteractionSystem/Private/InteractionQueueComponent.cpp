@@ -3,14 +3,26 @@
 
 #include "InteractionQueueComponent.h"
 
+#include "InteractionSavedState.h"
 #include "TrickyInteractionInterface.h"
 #include "TrickyInteractionLibrary.h"
+#include "TrickyInteractionScalability.h"
+#include "TrickyInteractionStats.h"
+#include "TrickyInteractionSubsystem.h"
 #include "Camera/CameraComponent.h"
+#include "Engine/StreamableManager.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Kismet/KismetSystemLibrary.h"
 
 DEFINE_LOG_CATEGORY(LogInteractionQueueComponent);
 
+DECLARE_CYCLE_STAT(TEXT("Tick InteractionQueue"), STAT_InteractionQueueTick, STATGROUP_TrickyInteraction);
+DECLARE_CYCLE_STAT(TEXT("Sort InteractionQueue"), STAT_InteractionQueueSort, STATGROUP_TrickyInteraction);
+DECLARE_CYCLE_STAT(TEXT("Broadcast Events"), STAT_InteractionBroadcastEvents, STATGROUP_TrickyInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Throttled Requests"), STAT_InteractionThrottledRequests, STATGROUP_TrickyInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cached Rejections"), STAT_InteractionCachedRejections, STATGROUP_TrickyInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Line Of Sight Revalidations"), STAT_InteractionRevalidations, STATGROUP_TrickyInteraction);
+
 UInteractionQueueComponent::UInteractionQueueComponent()
 {
 	PrimaryComponentTick.bCanEverTick = true;
@@ -26,14 +38,106 @@ void UInteractionQueueComponent::InitializeComponent()
 	ActorsToIgnore.AddUnique(GetOwner());
 }
 
+void UInteractionQueueComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	ApplyScalabilitySettings();
+
+	RequestTokens = static_cast<float>(InteractionRequestBurst);
+	RequestTokensUpdateTime = GetWorld()->GetTimeSeconds();
+
+	if (UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem())
+	{
+		Subsystem->RegisterQueueComponent(this);
+	}
+}
+
+void UInteractionQueueComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem())
+	{
+		Subsystem->UnregisterQueueComponent(this);
+
+		for (AActor* InteractiveActor : InteractionQueue)
+		{
+			Subsystem->UnregisterQueueEntry(InteractiveActor, this);
+		}
+	}
+
+	for (TPair<TObjectKey<AActor>, FInteractionAssetsRequest>& Pair : InteractionAssetRequests)
+	{
+		Pair.Value.Handle->ReleaseHandle();
+	}
+
+	InteractionAssetRequests.Empty();
+	ClearActiveInteraction();
+
+	// Readers which keep the buffer see an empty queue after the component ended play
+	FInteractionQueueSnapshot EmptySnapshot;
+	EmptySnapshot.FrameNumber = GFrameCounter;
+	SnapshotBuffer->Publish(EmptySnapshot);
+
+#if WITH_EDITORONLY_DATA
+	EditorInteractionQueue.Empty();
+#endif
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void UInteractionQueueComponent::TickComponent(float DeltaTime,
                                                ELevelTick TickType,
                                                FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	SCOPE_CYCLE_COUNTER(STAT_InteractionQueueTick);
+	const FInteractionPerfCounters::FTickTimeScope TickTimeScope;
+
+	// With the prediction the view is sampled every frame, but traced once per tick interval
+	if (bPredictLineOfSight)
+	{
+		SampleLineOfSightView(DeltaTime);
+		TimeSinceLineOfSightCheck += DeltaTime;
+
+		if (TimeSinceLineOfSightCheck < FInteractionScalability::GetTickInterval())
+		{
+			return;
+		}
+	}
+
+	SortInteractionQueueIfPending();
+
+	// Over the trace budget the last line of sight result is kept and the trace is retried on the next frame,
+	// where a slot of the budget is reserved for this component
+	UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem();
 
+	if (IsValid(CameraComponent) && Subsystem && !Subsystem->TryConsumeTraceBudget(this))
+	{
+		if (!bIsLineOfSightTraceStarved)
+		{
+			bIsLineOfSightTraceStarved = true;
+			ApplyScalabilitySettings();
+		}
+
+		return;
+	}
+
+	if (bIsLineOfSightTraceStarved)
+	{
+		bIsLineOfSightTraceStarved = false;
+		ApplyScalabilitySettings();
+	}
+
+	TimeSinceLineOfSightCheck = 0.f;
+
+	const AActor* PreviousActorInSight = ActorInSight;
 	FHitResult HitResult;
-	CheckLineOfSight(DeltaTime, HitResult);
+	FVector ViewLocation = FVector::ZeroVector;
+	FQuat ViewRotation = FQuat::Identity;
+
+	if (GetLineOfSightView(DeltaTime, ViewLocation, ViewRotation))
+	{
+		CheckLineOfSight(ViewLocation, ViewRotation.GetForwardVector(), HitResult);
+	}
 
 	if (HitResult.bBlockingHit)
 	{
@@ -43,45 +147,128 @@ void UInteractionQueueComponent::TickComponent(float DeltaTime,
 			HitResult.Location);
 		const float DotProduct = FVector::DotProduct(TraceDirection, ImpactDirection);
 		ActorInSight = DotProduct < 0.f ? nullptr : HitResult.GetActor();
+	}
+	else
+	{
+		ActorInSight = nullptr;
+	}
 
-		if (UTrickyInteractionLibrary::IsActorInteractive(ActorInSight) && IsInInteractionQueue(ActorInSight))
-		{
-			FInteractionData InteractionData;
-			UTrickyInteractionLibrary::GetActorInteractionData(ActorInSight, InteractionData);
-
-			if (InteractionData.bRequiresLineOfSight)
-			{
-				const int32 Index = InteractionQueue.IndexOfByKey(ActorInSight);
-				InteractionQueue.Swap(Index, 0);
-			}
-			else
-			{
-				SortInteractionQueue();
-			}
-		}
-		else
-		{
-			SortInteractionQueue();
-		}
+	const FInteractionData* InteractionData = nullptr;
+
+	if (UTrickyInteractionLibrary::IsActorInteractive(ActorInSight) && IsInInteractionQueue(ActorInSight))
+	{
+		InteractionData = UTrickyInteractionLibrary::FindActorInteractionData(ActorInSight);
+	}
+
+	if (InteractionData && InteractionData->bRequiresLineOfSight)
+	{
+		const int32 Index = InteractionQueue.IndexOfByKey(ActorInSight);
+		InteractionQueue.Swap(Index, 0);
+	}
+	else if (ActorInSight != PreviousActorInSight
+		&& !InteractionQueue.IsEmpty()
+		&& InteractionQueue[0] == PreviousActorInSight)
+	{
+		// The actor swapped to the head while it was in sight leaves the head together with the view
+		SortInteractionQueue();
+	}
+	else
+	{
+		SortInteractionQueueOnTick();
+	}
+
+	UpdateInteractionQueueHead();
+}
+
+void UInteractionQueueComponent::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	UInteractionQueueComponent* This = CastChecked<UInteractionQueueComponent>(InThis);
+
+	for (AActor*& InteractiveActor : This->InteractionQueue)
+	{
+		Collector.AddReferencedObject(InteractiveActor, This);
+	}
+
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
+void UInteractionQueueComponent::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	// Containers without reflection aren't counted by the base implementation
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(InteractionQueue.GetAllocatedSize()
+		+ PendingEvents.GetAllocatedSize()
+		+ DispatchingEvents.GetAllocatedSize()
+		+ InteractionAssetRequests.GetAllocatedSize());
+
+	if (CumulativeResourceSize.GetResourceSizeMode() == EResourceSizeMode::Exclusive)
+	{
+		CumulativeResourceSize.AddDedicatedSystemMemoryBytes(ActorsToIgnore.GetAllocatedSize());
 	}
 }
 
 bool UInteractionQueueComponent::AddToInteractionQueue(AActor* InteractiveActor)
+{
+	const bool bIsAdded = AddToInteractionQueueInternal(InteractiveActor);
+
+	if (OnInteractionQueueCallNative.IsBound())
+	{
+		FInteractionQueueCall Call;
+		Call.Type = FInteractionQueueCall::EType::Add;
+		Call.InteractiveActor = InteractiveActor;
+		Call.Result = bIsAdded;
+		OnInteractionQueueCallNative.Broadcast(this, Call);
+	}
+
+	return bIsAdded;
+}
+
+bool UInteractionQueueComponent::AddToInteractionQueueInternal(AActor* InteractiveActor)
 {
 	if (!UTrickyInteractionLibrary::IsActorInteractive(InteractiveActor) || IsInInteractionQueue(InteractiveActor))
 	{
 		return false;
 	}
 
+	UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem();
+
+	// Actors of a streamed level are added with one batch at the end of the frame
+	if (Subsystem && Subsystem->TryDeferQueueAdd(InteractiveActor, this))
+	{
+		return true;
+	}
+
+	const int32 PreviousQueueMax = InteractionQueue.Max();
 	InteractionQueue.Emplace(InteractiveActor);
-	SortInteractionQueue();
+	FInteractionPerfCounters::ContainerAllocationsNum += InteractionQueue.Max() != PreviousQueueMax ? 1 : 0;
+
+	if (Subsystem)
+	{
+		Subsystem->RegisterQueueEntry(InteractiveActor, this);
+	}
+
+	if (IsEventDispatchDeferred())
+	{
+		bIsSortPending = true;
+	}
+	else
+	{
+		SortInteractionQueue();
+	}
+
+	RequestInteractionAssets(InteractiveActor);
 
 	if (bUseLineOfSight && !IsComponentTickEnabled())
 	{
 		ToggleComponentTick();
 	}
 
-	OnActorAddedToInteractionQueue.Broadcast(this, InteractiveActor);
+	FInteractionQueueEvent Event;
+	Event.Type = FInteractionQueueEvent::EType::ActorAdded;
+	Event.InteractiveActor = InteractiveActor;
+	DispatchEvent(Event);
+	UpdateInteractionQueueHead();
 
 #if WITH_EDITOR && !UE_BUILD_SHIPPING
 	FString ActorName, OwnerName = GetOwner()->GetActorNameOrLabel();
@@ -95,9 +282,36 @@ bool UInteractionQueueComponent::AddToInteractionQueue(AActor* InteractiveActor)
 
 bool UInteractionQueueComponent::RemoveFromInteractionQueue(AActor* InteractiveActor)
 {
-	const bool bIsInteractiveActor = UTrickyInteractionLibrary::IsActorInteractive(InteractiveActor);
+	const bool bIsRemoved = RemoveFromInteractionQueueInternal(InteractiveActor);
+
+	if (OnInteractionQueueCallNative.IsBound())
+	{
+		FInteractionQueueCall Call;
+		Call.Type = FInteractionQueueCall::EType::Remove;
+		Call.InteractiveActor = InteractiveActor;
+		Call.Result = bIsRemoved;
+		OnInteractionQueueCallNative.Broadcast(this, Call);
+	}
+
+	return bIsRemoved;
+}
+
+bool UInteractionQueueComponent::RemoveFromInteractionQueueInternal(AActor* InteractiveActor)
+{
+	// Actors which were destroyed or stopped being interactive still can be removed
+	if (!InteractiveActor)
+	{
+		return false;
+	}
+
+	UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem();
+
+	if (Subsystem && Subsystem->CancelDeferredQueueAdd(InteractiveActor, this))
+	{
+		return true;
+	}
 
-	if (!bIsInteractiveActor || !IsInInteractionQueue(InteractiveActor) || IsInteractionQueueEmpty())
+	if (IsInteractionQueueEmpty())
 	{
 		return false;
 	}
@@ -107,8 +321,28 @@ bool UInteractionQueueComponent::RemoveFromInteractionQueue(AActor* InteractiveA
 		return false;
 	}
 
-	SortInteractionQueue();
-	OnActorRemovedFromInteractionQueue.Broadcast(this, InteractiveActor);
+	if (InteractiveActor == ActiveInteractionActor)
+	{
+		ClearActiveInteraction();
+	}
+
+	if (Subsystem)
+	{
+		Subsystem->UnregisterQueueEntry(InteractiveActor, this);
+	}
+
+	ReleaseInteractionAssets(InteractiveActor);
+
+	if (!IsEventDispatchDeferred())
+	{
+		SortInteractionQueue();
+	}
+
+	FInteractionQueueEvent Event;
+	Event.Type = FInteractionQueueEvent::EType::ActorRemoved;
+	Event.InteractiveActor = InteractiveActor;
+	DispatchEvent(Event);
+	UpdateInteractionQueueHead();
 
 	if (IsInteractionQueueEmpty())
 	{
@@ -125,143 +359,220 @@ bool UInteractionQueueComponent::RemoveFromInteractionQueue(AActor* InteractiveA
 	return true;
 }
 
-bool UInteractionQueueComponent::IsInInteractionQueue(AActor* Actor)
+int32 UInteractionQueueComponent::AddToInteractionQueueBatch(const TArray<AActor*>& InteractiveActors)
 {
-	if (!UTrickyInteractionLibrary::IsActorInteractive(Actor))
+	const int32 AddedNum = AddToInteractionQueueBatchInternal(InteractiveActors);
+
+	if (OnInteractionQueueCallNative.IsBound())
 	{
-		return false;
+		FInteractionQueueCall Call;
+		Call.Type = FInteractionQueueCall::EType::AddBatch;
+		Call.InteractiveActors = InteractiveActors;
+		Call.Result = AddedNum;
+		OnInteractionQueueCallNative.Broadcast(this, Call);
 	}
 
-	return InteractionQueue.Contains(Actor);
+	return AddedNum;
 }
 
-void UInteractionQueueComponent::SetUseLineOfSight(bool Value)
+int32 UInteractionQueueComponent::AddToInteractionQueueBatchInternal(const TArray<AActor*>& InteractiveActors)
 {
-	if (bUseLineOfSight == Value)
+	UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem();
+	TArray<AActor*, TInlineAllocator<16>> AddedActors;
+	const int32 PreviousQueueMax = InteractionQueue.Max();
+	InteractionQueue.Reserve(InteractionQueue.Num() + InteractiveActors.Num());
+	FInteractionPerfCounters::ContainerAllocationsNum += InteractionQueue.Max() != PreviousQueueMax ? 1 : 0;
+
+	for (AActor* InteractiveActor : InteractiveActors)
 	{
-		return;
-	}
+		if (!UTrickyInteractionLibrary::IsActorInteractive(InteractiveActor) || InteractionQueue.Contains(InteractiveActor))
+		{
+			continue;
+		}
 
-	bUseLineOfSight = Value;
-}
+		InteractionQueue.Emplace(InteractiveActor);
+		AddedActors.Add(InteractiveActor);
 
-EInteractionResult UInteractionQueueComponent::StartInteraction()
-{
-	AActor* Interactor = GetOwner();
+		if (Subsystem)
+		{
+			Subsystem->RegisterQueueEntry(InteractiveActor, this);
+		}
+	}
 
-	if (IsInteractionQueueEmpty() || !IsValid(Interactor))
+	if (AddedActors.IsEmpty())
 	{
-		return EInteractionResult::Invalid;
+		return 0;
 	}
 
-	AActor* InteractiveActor = InteractionQueue[0];
-
-	if (!IsValid(InteractiveActor))
+	if (IsEventDispatchDeferred())
 	{
-		return EInteractionResult::Invalid;
+		bIsSortPending = true;
+	}
+	else
+	{
+		SortInteractionQueue();
 	}
 
-	FInteractionData InteractionData;
-	UTrickyInteractionLibrary::GetActorInteractionData(InteractiveActor, InteractionData);
+	for (AActor* InteractiveActor : AddedActors)
+	{
+		RequestInteractionAssets(InteractiveActor);
+	}
 
-	if (InteractionData.bRequiresLineOfSight && InteractiveActor != ActorInSight)
+	if (bUseLineOfSight && !IsComponentTickEnabled())
 	{
-		return EInteractionResult::Invalid;
+		ToggleComponentTick();
 	}
 
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-	FString ActorName, OwnerName = GetOwner()->GetActorNameOrLabel();
-	GetNames(OwnerName, InteractiveActor, ActorName);
-#endif
+	for (AActor* InteractiveActor : AddedActors)
+	{
+		FInteractionQueueEvent Event;
+		Event.Type = FInteractionQueueEvent::EType::ActorAdded;
+		Event.InteractiveActor = InteractiveActor;
+		DispatchEvent(Event);
+	}
 
-	const EInteractionResult InteractionResult = ITrickyInteractionInterface::Execute_StartInteraction(InteractiveActor, Interactor);
-	UTrickyInteractionLibrary::GetActorInteractionData(InteractiveActor, InteractionData);
-	OnInteractionStarted.Broadcast(this, InteractiveActor, InteractionResult);
+	UpdateInteractionQueueHead();
 
 #if WITH_EDITOR && !UE_BUILD_SHIPPING
-	FString Result = "NONE";
-	GetInteractionResultName(InteractionResult, Result);
-	const FString Message = FString::Printf(
-		TEXT("%s started interaction with %s. Result %s"), *OwnerName, *ActorName, *Result);
+	const FString Message = FString::Printf(TEXT("%d actors added to InteractionQueue of %s"),
+	                                        AddedActors.Num(),
+	                                        *GetOwner()->GetActorNameOrLabel());
 	PrintLog(Message);
 #endif
 
-	return InteractionResult;
+	return AddedActors.Num();
 }
 
-EInteractionResult UInteractionQueueComponent::FinishInteraction()
+int32 UInteractionQueueComponent::RemoveFromInteractionQueueBatch(const TArray<AActor*>& InteractiveActors)
 {
-	AActor* Interactor = GetOwner();
+	const int32 RemovedNum = RemoveFromInteractionQueueBatchInternal(InteractiveActors);
 
-	if (IsInteractionQueueEmpty() || !IsValid(Interactor))
+	if (OnInteractionQueueCallNative.IsBound())
 	{
-		return EInteractionResult::Invalid;
+		FInteractionQueueCall Call;
+		Call.Type = FInteractionQueueCall::EType::RemoveBatch;
+		Call.InteractiveActors = InteractiveActors;
+		Call.Result = RemovedNum;
+		OnInteractionQueueCallNative.Broadcast(this, Call);
 	}
 
-	AActor* InteractiveActor = InteractionQueue[0];
+	return RemovedNum;
+}
+
+int32 UInteractionQueueComponent::RemoveFromInteractionQueueBatchInternal(const TArray<AActor*>& InteractiveActors)
+{
+	UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem();
+	TArray<AActor*, TInlineAllocator<16>> RemovedActors;
 
-	if (!IsValid(InteractiveActor))
+	// Removal keeps the relative order of the sorted queue, so it doesn't need to be sorted again
+	for (AActor* InteractiveActor : InteractiveActors)
 	{
-		return EInteractionResult::Invalid;
+		if (!InteractiveActor
+			|| (Subsystem && Subsystem->CancelDeferredQueueAdd(InteractiveActor, this))
+			|| InteractionQueue.RemoveSingle(InteractiveActor) <= 0)
+		{
+			continue;
+		}
+
+		RemovedActors.Add(InteractiveActor);
+
+		if (InteractiveActor == ActiveInteractionActor)
+		{
+			ClearActiveInteraction();
+		}
+
+		if (Subsystem)
+		{
+			Subsystem->UnregisterQueueEntry(InteractiveActor, this);
+		}
+
+		ReleaseInteractionAssets(InteractiveActor);
 	}
 
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-	FString ActorName, OwnerName = GetOwner()->GetActorNameOrLabel();
-	GetNames(OwnerName, InteractiveActor, ActorName);
-#endif
-	
-	const EInteractionResult InteractionResult = ITrickyInteractionInterface::Execute_FinishInteraction(InteractiveActor, Interactor);
-	OnInteractionFinished.Broadcast(this, InteractiveActor, InteractionResult);
+	if (RemovedActors.IsEmpty())
+	{
+		return 0;
+	}
+
+	if (IsInteractionQueueEmpty())
+	{
+		SetComponentTickEnabled(false);
+	}
+
+	for (AActor* InteractiveActor : RemovedActors)
+	{
+		FInteractionQueueEvent Event;
+		Event.Type = FInteractionQueueEvent::EType::ActorRemoved;
+		Event.InteractiveActor = InteractiveActor;
+		DispatchEvent(Event);
+	}
+
+	UpdateInteractionQueueHead();
 
 #if WITH_EDITOR && !UE_BUILD_SHIPPING
-	FString Result = "NONE";
-	GetInteractionResultName(InteractionResult, Result);
-	const FString Message = FString::Printf(
-		TEXT("%s finished interaction with %s. Result %s"), *OwnerName, *ActorName, *Result);
+	const FString Message = FString::Printf(TEXT("%d actors removed from InteractionQueue of %s"),
+	                                        RemovedActors.Num(),
+	                                        *GetOwner()->GetActorNameOrLabel());
 	PrintLog(Message);
 #endif
 
-	return InteractionResult;
+	return RemovedActors.Num();
 }
 
-EInteractionResult UInteractionQueueComponent::InterruptInteraction(AActor* Interruptor)
+TArray<AActor*> UInteractionQueueComponent::GetInteractionQueue() const
 {
-	AActor* Interactor = GetOwner();
+	SortInteractionQueueIfPending();
+	return TArray<AActor*>(InteractionQueue);
+}
 
-	if (IsInteractionQueueEmpty() || !IsValid(Interactor))
+TConstArrayView<AActor*> UInteractionQueueComponent::GetInteractionQueueView() const
+{
+	SortInteractionQueueIfPending();
+	return InteractionQueue;
+}
+
+AActor* UInteractionQueueComponent::GetInteractionQueueHead() const
+{
+	SortInteractionQueueIfPending();
+	return IsInteractionQueueEmpty() ? nullptr : InteractionQueue[0];
+}
+
+bool UInteractionQueueComponent::IsInInteractionQueue(AActor* Actor)
+{
+	if (!UTrickyInteractionLibrary::IsActorInteractive(Actor))
 	{
-		return EInteractionResult::Invalid;
+		return false;
 	}
 
-	AActor* InteractiveActor = InteractionQueue[0];
+	return InteractionQueue.Contains(Actor);
+}
 
-	if (!IsValid(InteractiveActor))
+void UInteractionQueueComponent::SetUseLineOfSight(bool Value)
+{
+	if (bUseLineOfSight == Value)
 	{
-		return EInteractionResult::Invalid;
+		return;
 	}
 
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-	FString ActorName, OwnerName = GetOwner()->GetActorNameOrLabel();
-	GetNames(OwnerName, InteractiveActor, ActorName);
-#endif
-	
-	const EInteractionResult InteractionResult = ITrickyInteractionInterface::Execute_InterruptInteraction(
-		InteractiveActor, Interruptor, Interactor);
-	OnInteractionInterrupted.Broadcast(this, InteractiveActor, Interruptor, InteractionResult);
+	bUseLineOfSight = Value;
+}
 
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-	const FString InterruptorName = Interruptor->GetActorNameOrLabel();
-	FString Result = "NONE";
-	GetInteractionResultName(InteractionResult, Result);
-	const FString Message = FString::Printf(
-		TEXT("%s interrupts %s interaction with %s. Result: %s"), *InterruptorName, *OwnerName, *ActorName, *Result);
-	PrintLog(Message);
-#endif
+EInteractionResult UInteractionQueueComponent::StartInteraction()
+{
+	FInteractionQueueCall Call;
+	Call.Type = FInteractionQueueCall::EType::Start;
+	return ReportTargetedCall(Call, [this]() { return StartInteractionInternal(-1.f); });
+}
 
-	return InteractionResult;
+EInteractionResult UInteractionQueueComponent::StartTimedInteraction(const float Duration)
+{
+	FInteractionQueueCall Call;
+	Call.Type = FInteractionQueueCall::EType::StartTimed;
+	Call.Duration = Duration;
+	return ReportTargetedCall(Call, [this, Duration]() { return StartInteractionInternal(FMath::Max(Duration, 0.f)); });
 }
 
-EInteractionResult UInteractionQueueComponent::ForceInteraction()
+EInteractionResult UInteractionQueueComponent::StartInteractionInternal(const float DurationOverride)
 {
 	AActor* Interactor = GetOwner();
 
@@ -270,77 +581,1166 @@ EInteractionResult UInteractionQueueComponent::ForceInteraction()
 		return EInteractionResult::Invalid;
 	}
 
-	AActor* InteractiveActor = InteractionQueue[0];
+	EInteractionResult RejectedResult;
 
-	if (!IsValid(InteractiveActor))
+	if (ShouldRejectRequest(RejectedStartRequest, RejectedResult))
 	{
-		return EInteractionResult::Invalid;
+		return RejectedResult;
 	}
 
-	FInteractionData InteractionData;
-	UTrickyInteractionLibrary::GetActorInteractionData(InteractiveActor, InteractionData);
+	SortInteractionQueueIfPending();
+
+	AActor* InteractiveActor = GetInteractionTarget();
 
-	if (InteractionData.bRequiresLineOfSight && InteractiveActor != ActorInSight)
+	if (!InteractiveActor)
 	{
-		return EInteractionResult::Invalid;
+		// Every actor in the queue is fully reserved by other interactors
+		CacheRequestResult(RejectedStartRequest, EInteractionResult::Failure);
+		return EInteractionResult::Failure;
 	}
 
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
+	if (!IsValid(InteractiveActor))
+	{
+		return EInteractionResult::Invalid;
+	}
+
+	const FInteractionData* InteractionData = UTrickyInteractionLibrary::FindActorInteractionData(InteractiveActor);
+
+	bool bIsOverTraceBudget = false;
+
+	if (!InteractionData
+		|| (InteractionData->bRequiresLineOfSight && !IsInLineOfSight(InteractiveActor, bIsOverTraceBudget)))
+	{
+		// The view wasn't checked, so a repeated request may succeed
+		if (bIsOverTraceBudget)
+		{
+			return EInteractionResult::Failure;
+		}
+
+		CacheRequestResult(RejectedStartRequest, EInteractionResult::Invalid);
+		return EInteractionResult::Invalid;
+	}
+
+#if WITH_EDITOR && !UE_BUILD_SHIPPING
+	FString ActorName, OwnerName = GetOwner()->GetActorNameOrLabel();
+	GetNames(OwnerName, InteractiveActor, ActorName);
+#endif
+
+	// The actor is claimed before the interface is called, so two interactors can't start on the last free slot
+	UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem();
+	const bool bIsAlreadyClaimed = bHasActiveInteraction && ActiveInteractionActor == InteractiveActor;
+
+	if (Subsystem && !bIsAlreadyClaimed && !Subsystem->TryReserveInteraction(InteractiveActor, this, ReservationTimeout))
+	{
+		CacheRequestResult(RejectedStartRequest, EInteractionResult::Failure);
+		return EInteractionResult::Failure;
+	}
+
+	const EInteractionResult InteractionResult = UTrickyInteractionLibrary::ExecuteStartInteraction(InteractiveActor, Interactor);
+	CacheRequestResult(RejectedStartRequest, InteractionResult);
+
+	if (InteractionResult == EInteractionResult::Success)
+	{
+		// Only the claim of the previous actor is released
+		if (bIsAlreadyClaimed)
+		{
+			ActiveInteractionActor = nullptr;
+		}
+
+		ClearActiveInteraction();
+		ActiveInteractionActor = InteractiveActor;
+		bHasActiveInteraction = true;
+
+		const float Duration = DurationOverride >= 0.f ? DurationOverride : InteractionData->InteractionDuration;
+		StartTimedInteractionTimer(Duration);
+	}
+	else if (Subsystem && !bIsAlreadyClaimed)
+	{
+		Subsystem->ReleaseInteraction(InteractiveActor, this);
+	}
+
+	FInteractionQueueEvent Event;
+	Event.Type = FInteractionQueueEvent::EType::InteractionStarted;
+	Event.InteractiveActor = InteractiveActor;
+	Event.InteractionResult = InteractionResult;
+	DispatchEvent(Event);
+
+#if WITH_EDITOR && !UE_BUILD_SHIPPING
+	FString Result = "NONE";
+	GetInteractionResultName(InteractionResult, Result);
+	const FString Message = FString::Printf(
+		TEXT("%s started interaction with %s. Result %s"), *OwnerName, *ActorName, *Result);
+	PrintLog(Message);
+#endif
+
+	return InteractionResult;
+}
+
+EInteractionResult UInteractionQueueComponent::FinishInteraction()
+{
+	const EInteractionResult InteractionResult = FinishInteractionInternal();
+
+	if (OnInteractionQueueCallNative.IsBound())
+	{
+		FInteractionQueueCall Call;
+		Call.Type = FInteractionQueueCall::EType::Finish;
+		Call.Result = static_cast<int32>(InteractionResult);
+		OnInteractionQueueCallNative.Broadcast(this, Call);
+	}
+
+	return InteractionResult;
+}
+
+EInteractionResult UInteractionQueueComponent::FinishInteractionInternal()
+{
+	AActor* Interactor = GetOwner();
+
+	if (IsInteractionQueueEmpty() || !IsValid(Interactor))
+	{
+		return EInteractionResult::Invalid;
+	}
+
+	SortInteractionQueueIfPending();
+
+	AActor* InteractiveActor = GetActiveInteractionTarget();
+
+	if (!IsValid(InteractiveActor))
+	{
+		return EInteractionResult::Invalid;
+	}
+
+#if WITH_EDITOR && !UE_BUILD_SHIPPING
 	FString ActorName, OwnerName = GetOwner()->GetActorNameOrLabel();
 	GetNames(OwnerName, InteractiveActor, ActorName);
 #endif
 	
-	const EInteractionResult InteractionResult = ITrickyInteractionInterface::Execute_ForceInteraction(InteractiveActor, Interactor);
-	OnInteractionForced.Broadcast(this, InteractiveActor, InteractionResult);
+	const EInteractionResult InteractionResult = UTrickyInteractionLibrary::ExecuteFinishInteraction(InteractiveActor, Interactor);
+
+	if (InteractionResult == EInteractionResult::Success && InteractiveActor == ActiveInteractionActor)
+	{
+		ClearActiveInteraction();
+	}
+
+	FInteractionQueueEvent Event;
+	Event.Type = FInteractionQueueEvent::EType::InteractionFinished;
+	Event.InteractiveActor = InteractiveActor;
+	Event.InteractionResult = InteractionResult;
+	DispatchEvent(Event);
+
+#if WITH_EDITOR && !UE_BUILD_SHIPPING
+	FString Result = "NONE";
+	GetInteractionResultName(InteractionResult, Result);
+	const FString Message = FString::Printf(
+		TEXT("%s finished interaction with %s. Result %s"), *OwnerName, *ActorName, *Result);
+	PrintLog(Message);
+#endif
+
+	return InteractionResult;
+}
+
+EInteractionResult UInteractionQueueComponent::InterruptInteraction(AActor* Interruptor)
+{
+	const EInteractionResult InteractionResult = InterruptInteractionInternal(Interruptor);
+
+	if (OnInteractionQueueCallNative.IsBound())
+	{
+		FInteractionQueueCall Call;
+		Call.Type = FInteractionQueueCall::EType::Interrupt;
+		Call.Interruptor = Interruptor;
+		Call.Result = static_cast<int32>(InteractionResult);
+		OnInteractionQueueCallNative.Broadcast(this, Call);
+	}
+
+	return InteractionResult;
+}
+
+EInteractionResult UInteractionQueueComponent::InterruptInteractionInternal(AActor* Interruptor)
+{
+	AActor* Interactor = GetOwner();
+
+	if (IsInteractionQueueEmpty() || !IsValid(Interactor))
+	{
+		return EInteractionResult::Invalid;
+	}
+
+	SortInteractionQueueIfPending();
+
+	AActor* InteractiveActor = GetActiveInteractionTarget();
+
+	if (!IsValid(InteractiveActor))
+	{
+		return EInteractionResult::Invalid;
+	}
+
+#if WITH_EDITOR && !UE_BUILD_SHIPPING
+	FString ActorName, OwnerName = GetOwner()->GetActorNameOrLabel();
+	GetNames(OwnerName, InteractiveActor, ActorName);
+#endif
+	
+	const EInteractionResult InteractionResult = UTrickyInteractionLibrary::ExecuteInterruptInteraction(
+		InteractiveActor, Interruptor, Interactor);
+
+	if (InteractionResult == EInteractionResult::Success && InteractiveActor == ActiveInteractionActor)
+	{
+		ClearActiveInteraction();
+	}
+
+	FInteractionQueueEvent Event;
+	Event.Type = FInteractionQueueEvent::EType::InteractionInterrupted;
+	Event.InteractiveActor = InteractiveActor;
+	Event.Interruptor = Interruptor;
+	Event.InteractionResult = InteractionResult;
+	DispatchEvent(Event);
+
+#if WITH_EDITOR && !UE_BUILD_SHIPPING
+	const FString InterruptorName = IsValid(Interruptor) ? Interruptor->GetActorNameOrLabel() : TEXT("NULL");
+	FString Result = "NONE";
+	GetInteractionResultName(InteractionResult, Result);
+	const FString Message = FString::Printf(
+		TEXT("%s interrupts %s interaction with %s. Result: %s"), *InterruptorName, *OwnerName, *ActorName, *Result);
+	PrintLog(Message);
+#endif
+
+	return InteractionResult;
+}
+
+EInteractionResult UInteractionQueueComponent::ForceInteraction()
+{
+	FInteractionQueueCall Call;
+	Call.Type = FInteractionQueueCall::EType::Force;
+	return ReportTargetedCall(Call, [this]() { return ForceInteractionInternal(); });
+}
+
+EInteractionResult UInteractionQueueComponent::ReportTargetedCall(FInteractionQueueCall& Call,
+                                                                  const TFunctionRef<EInteractionResult()> CallFunction)
+{
+	if (!OnInteractionQueueCallNative.IsBound())
+	{
+		return CallFunction();
+	}
+
+	Call.InteractiveActor = GetInteractionTarget();
+	const EInteractionResult InteractionResult = CallFunction();
+	Call.Result = static_cast<int32>(InteractionResult);
+	OnInteractionQueueCallNative.Broadcast(this, Call);
+	return InteractionResult;
+}
+
+EInteractionResult UInteractionQueueComponent::ForceInteractionInternal()
+{
+	AActor* Interactor = GetOwner();
+
+	if (IsInteractionQueueEmpty() || !IsValid(Interactor))
+	{
+		return EInteractionResult::Invalid;
+	}
+
+	EInteractionResult RejectedResult;
+
+	if (ShouldRejectRequest(RejectedForceRequest, RejectedResult))
+	{
+		return RejectedResult;
+	}
+
+	SortInteractionQueueIfPending();
+
+	AActor* InteractiveActor = GetInteractionTarget();
+
+	if (!InteractiveActor)
+	{
+		// Every actor in the queue is fully reserved by other interactors
+		CacheRequestResult(RejectedForceRequest, EInteractionResult::Failure);
+		return EInteractionResult::Failure;
+	}
+
+	if (!IsValid(InteractiveActor))
+	{
+		return EInteractionResult::Invalid;
+	}
+
+	const FInteractionData* InteractionData = UTrickyInteractionLibrary::FindActorInteractionData(InteractiveActor);
+
+	bool bIsOverTraceBudget = false;
+
+	if (!InteractionData
+		|| (InteractionData->bRequiresLineOfSight && !IsInLineOfSight(InteractiveActor, bIsOverTraceBudget)))
+	{
+		// The view wasn't checked, so a repeated request may succeed
+		if (bIsOverTraceBudget)
+		{
+			return EInteractionResult::Failure;
+		}
+
+		CacheRequestResult(RejectedForceRequest, EInteractionResult::Invalid);
+		return EInteractionResult::Invalid;
+	}
+
+#if WITH_EDITOR && !UE_BUILD_SHIPPING
+	FString ActorName, OwnerName = GetOwner()->GetActorNameOrLabel();
+	GetNames(OwnerName, InteractiveActor, ActorName);
+#endif
+	
+	const EInteractionResult InteractionResult = UTrickyInteractionLibrary::ExecuteForceInteraction(InteractiveActor, Interactor);
+	CacheRequestResult(RejectedForceRequest, InteractionResult);
+	FInteractionQueueEvent Event;
+	Event.Type = FInteractionQueueEvent::EType::InteractionForced;
+	Event.InteractiveActor = InteractiveActor;
+	Event.InteractionResult = InteractionResult;
+	DispatchEvent(Event);
+
+#if WITH_EDITOR && !UE_BUILD_SHIPPING
+	FString Result = "NONE";
+	GetInteractionResultName(InteractionResult, Result);
+	const FString Message = FString::Printf(
+		TEXT("%s forced interaction with %s. Result %s"), *OwnerName, *ActorName, *Result);
+	PrintLog(Message);
+#endif
+
+	return InteractionResult;
+}
+
+void UInteractionQueueComponent::ClearRejectedInteractionRequests()
+{
+	RejectedStartRequest.Reset();
+	RejectedForceRequest.Reset();
+}
+
+void UInteractionQueueComponent::SaveInteractionState(TArray<uint8>& OutData) const
+{
+	const UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem();
+	FInteractionQueueSavedState SavedState;
+	SavedState.Entries.Reserve(InteractionQueue.Num());
+
+	// The queue is saved sorted, so the cached weights only tell if it has to be sorted after restoring
+	for (AActor* InteractiveActor : InteractionQueue)
+	{
+		const FInteractionActorId ActorId = Subsystem ? Subsystem->MakeActorId(InteractiveActor) : FInteractionActorId();
+
+		if (!ActorId.IsValid())
+		{
+#if WITH_EDITOR && !UE_BUILD_SHIPPING
+			UE_LOG(LogInteractionQueueComponent, Log,
+			       TEXT("%s isn't saved in InteractionQueue of %s. It was spawned at runtime and has no persistent ID."),
+			       *GetNameSafe(InteractiveActor),
+			       *GetOwner()->GetActorNameOrLabel());
+#endif
+			continue;
+		}
+
+		if (InteractiveActor == ActiveInteractionActor)
+		{
+			SavedState.ActiveIndex = SavedState.Entries.Num();
+		}
+
+		FInteractionQueueSavedState::FEntry& Entry = SavedState.Entries.AddDefaulted_GetRef();
+		Entry.ActorId = ActorId;
+		Entry.Weight = GetInteractionSortWeight(InteractiveActor);
+	}
+
+	if (IsTimedInteractionActive())
+	{
+		SavedState.TimedDuration = TimedInteractionDuration;
+		SavedState.TimedElapsedTime = TimedInteractionDuration - GetTimedInteractionRemainingTime();
+	}
+
+	SavedState.Write(OutData);
+}
+
+bool UInteractionQueueComponent::RestoreInteractionState(const TArray<uint8>& Data)
+{
+	UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem();
+	FInteractionQueueSavedState SavedState;
+
+	if (!Subsystem || !SavedState.Read(Data))
+	{
+#if WITH_EDITOR && !UE_BUILD_SHIPPING
+		const FString Message = FString::Printf(TEXT("Can't restore InteractionQueue of %s. The saved state is invalid."),
+		                                        *GetOwner()->GetActorNameOrLabel());
+		PrintWarning(Message);
+#endif
+		return false;
+	}
+
+	TArray<AActor*> OverlappingActors;
+
+	if (bReconcileOverlapsOnRestore)
+	{
+		GetOwner()->GetOverlappingActors(OverlappingActors);
+	}
+
+	// Saved actors which still exist, are interactive and, if reconciled, still overlap the owner
+	TArray<AActor*, TInlineAllocator<InlineQueueCapacity>> RestoredActors;
+	RestoredActors.Reserve(SavedState.Entries.Num());
+	AActor* ActiveActor = nullptr;
+	bool bHaveWeightsChanged = false;
+
+	for (int32 i = 0; i < SavedState.Entries.Num(); ++i)
+	{
+		const FInteractionQueueSavedState::FEntry& Entry = SavedState.Entries[i];
+		AActor* InteractiveActor = Subsystem->ResolveActorId(Entry.ActorId);
+
+		if (!UTrickyInteractionLibrary::IsActorInteractive(InteractiveActor)
+			|| RestoredActors.Contains(InteractiveActor)
+			|| (bReconcileOverlapsOnRestore && !OverlappingActors.Contains(InteractiveActor)))
+		{
+			continue;
+		}
+
+		RestoredActors.Add(InteractiveActor);
+		bHaveWeightsChanged |= GetInteractionSortWeight(InteractiveActor) != Entry.Weight;
+
+		if (i == SavedState.ActiveIndex)
+		{
+			ActiveActor = InteractiveActor;
+		}
+	}
+
+	// Interactive actors which started overlapping the owner after saving
+	const int32 SavedActorsNum = RestoredActors.Num();
+
+	for (AActor* OverlappingActor : OverlappingActors)
+	{
+		if (UTrickyInteractionLibrary::IsActorInteractive(OverlappingActor) && !RestoredActors.Contains(OverlappingActor))
+		{
+			RestoredActors.Add(OverlappingActor);
+		}
+	}
+
+	ClearActiveInteraction();
+	ClearRejectedInteractionRequests();
+
+	const TArray<AActor*, TInlineAllocator<InlineQueueCapacity>> PreviousQueue = InteractionQueue;
+	InteractionQueue.Reset();
+	InteractionQueue.Append(RestoredActors);
+
+	TArray<AActor*, TInlineAllocator<InlineQueueCapacity>> RemovedActors;
+	TArray<AActor*, TInlineAllocator<InlineQueueCapacity>> AddedActors;
+
+	for (AActor* InteractiveActor : PreviousQueue)
+	{
+		if (!InteractionQueue.Contains(InteractiveActor))
+		{
+			Subsystem->UnregisterQueueEntry(InteractiveActor, this);
+			ReleaseInteractionAssets(InteractiveActor);
+			RemovedActors.Add(InteractiveActor);
+		}
+	}
+
+	for (int32 i = 0; i < InteractionQueue.Num(); ++i)
+	{
+		AActor* InteractiveActor = InteractionQueue[i];
+
+		if (PreviousQueue.Contains(InteractiveActor))
+		{
+			continue;
+		}
+
+		Subsystem->RegisterQueueEntry(InteractiveActor, this);
+		RequestInteractionAssets(InteractiveActor);
+
+		// The actors of the saved queue were already reported before saving
+		if (i >= SavedActorsNum)
+		{
+			AddedActors.Add(InteractiveActor);
+		}
+	}
+
+	// The saved queue is already sorted
+	if (bHaveWeightsChanged || SavedActorsNum != InteractionQueue.Num())
+	{
+		if (IsEventDispatchDeferred())
+		{
+			bIsSortPending = true;
+		}
+		else
+		{
+			SortInteractionQueue();
+		}
+	}
+
+	SetComponentTickEnabled(bUseLineOfSight && !IsInteractionQueueEmpty());
+
+	// Another interactor could claim the actor since saving, it keeps the interaction
+	if (ActiveActor && !Subsystem->TryReserveInteraction(ActiveActor, this, ReservationTimeout))
+	{
+#if WITH_EDITOR && !UE_BUILD_SHIPPING
+		const FString Message = FString::Printf(
+			TEXT("Active interaction with %s isn't restored to InteractionQueue of %s. The actor is fully reserved."),
+			*ActiveActor->GetActorNameOrLabel(),
+			*GetOwner()->GetActorNameOrLabel());
+		PrintWarning(Message);
+#endif
+		ActiveActor = nullptr;
+	}
+
+	if (ActiveActor)
+	{
+		ActiveInteractionActor = ActiveActor;
+		bHasActiveInteraction = true;
+
+		// The timed interaction continues with its progress
+		if (SavedState.TimedDuration > 0.f && SavedState.TimedElapsedTime < SavedState.TimedDuration)
+		{
+			StartTimedInteractionTimer(SavedState.TimedDuration - SavedState.TimedElapsedTime);
+			TimedInteractionStartTime -= SavedState.TimedElapsedTime;
+			TimedInteractionDuration = SavedState.TimedDuration;
+		}
+	}
+
+	// Pending events are kept, the events of the restore follow them
+	for (AActor* InteractiveActor : RemovedActors)
+	{
+		FInteractionQueueEvent Event;
+		Event.Type = FInteractionQueueEvent::EType::ActorRemoved;
+		Event.InteractiveActor = InteractiveActor;
+		DispatchEvent(Event);
+	}
+
+	for (AActor* InteractiveActor : AddedActors)
+	{
+		FInteractionQueueEvent Event;
+		Event.Type = FInteractionQueueEvent::EType::ActorAdded;
+		Event.InteractiveActor = InteractiveActor;
+		DispatchEvent(Event);
+	}
+
+	UpdateInteractionQueueHead();
+
+#if WITH_EDITOR && !UE_BUILD_SHIPPING
+	const FString Message = FString::Printf(
+		TEXT("%d of %d saved actors restored to InteractionQueue of %s, %d overlapping actors added, %d actors removed"),
+		SavedActorsNum,
+		SavedState.Entries.Num(),
+		*GetOwner()->GetActorNameOrLabel(),
+		AddedActors.Num(),
+		RemovedActors.Num());
+	PrintLog(Message);
+#endif
+
+	return true;
+}
+
+bool UInteractionQueueComponent::ShouldRejectRequest(const TOptional<FRejectedRequest>& RejectedRequest,
+                                                     EInteractionResult& OutResult)
+{
+	if (!bThrottleInteractionRequests)
+	{
+		return false;
+	}
+
+	const double Time = GetWorld()->GetTimeSeconds();
+
+	// A repeated request in the same state would be rejected by the same checks
+	if (RejectedRequest.IsSet()
+		&& !bIsSortPending
+		&& Time < RejectedRequest->ExpirationTime
+		&& RejectedRequest->Head == TObjectKey<AActor>(GetInteractionQueueHead())
+		&& RejectedRequest->ActorInSight == TObjectKey<AActor>(ActorInSight)
+		&& IsRejectedRequestViewCurrent(RejectedRequest.GetValue()))
+	{
+		INC_DWORD_STAT(STAT_InteractionCachedRejections);
+		OutResult = RejectedRequest->Result;
+		return true;
+	}
+
+	const float RestoredTokens = static_cast<float>(Time - RequestTokensUpdateTime) * InteractionRequestRate;
+	RequestTokens = FMath::Min(RequestTokens + RestoredTokens, static_cast<float>(InteractionRequestBurst));
+	RequestTokensUpdateTime = Time;
+
+	if (RequestTokens < 1.f)
+	{
+		INC_DWORD_STAT(STAT_InteractionThrottledRequests);
+		OutResult = EInteractionResult::Failure;
+		return true;
+	}
+
+	RequestTokens -= 1.f;
+	return false;
+}
+
+void UInteractionQueueComponent::CacheRequestResult(TOptional<FRejectedRequest>& RejectedRequest,
+                                                    const EInteractionResult Result)
+{
+	if (!bThrottleInteractionRequests || RejectCacheDuration <= 0.f)
+	{
+		return;
+	}
+
+	if (Result == EInteractionResult::Success)
+	{
+		RejectedRequest.Reset();
+		return;
+	}
+
+	FRejectedRequest& Request = RejectedRequest.Emplace();
+	Request.Head = GetInteractionQueueHead();
+	Request.ActorInSight = ActorInSight;
+	Request.ExpirationTime = GetWorld()->GetTimeSeconds() + RejectCacheDuration;
+	Request.Result = Result;
+
+	// With the prediction the current view is re-validated, so the rejection holds only while the view stays
+	if (bPredictLineOfSight)
+	{
+		GetCurrentLineOfSightView(Request.ViewLocation, Request.ViewRotation);
+	}
+}
+
+bool UInteractionQueueComponent::IsRejectedRequestViewCurrent(const FRejectedRequest& RejectedRequest) const
+{
+	if (!bPredictLineOfSight)
+	{
+		return true;
+	}
+
+	FVector ViewLocation = FVector::ZeroVector;
+	FQuat ViewRotation = FQuat::Identity;
+	GetCurrentLineOfSightView(ViewLocation, ViewRotation);
+
+	const double LocationToleranceSquared = FMath::Square(RejectCacheViewLocationTolerance);
+
+	return FVector::DistSquared(ViewLocation, RejectedRequest.ViewLocation) <= LocationToleranceSquared
+		&& ViewRotation.AngularDistance(RejectedRequest.ViewRotation) <= RejectCacheViewAngleTolerance;
+}
+
+AActor* UInteractionQueueComponent::GetInteractionTarget() const
+{
+	const UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem();
+
+	for (AActor* InteractiveActor : InteractionQueue)
+	{
+		if (!Subsystem || !Subsystem->IsInteractionFullyReserved(InteractiveActor, this))
+		{
+			return InteractiveActor;
+		}
+	}
+
+	return nullptr;
+}
+
+float UInteractionQueueComponent::GetTimedInteractionProgress() const
+{
+	if (!IsTimedInteractionActive())
+	{
+		return 0.f;
+	}
+
+	const float ElapsedTime = static_cast<float>(GetWorld()->GetTimeSeconds() - TimedInteractionStartTime);
+	return FMath::Clamp(ElapsedTime / TimedInteractionDuration, 0.f, 1.f);
+}
+
+float UInteractionQueueComponent::GetTimedInteractionRemainingTime() const
+{
+	if (!IsTimedInteractionActive())
+	{
+		return 0.f;
+	}
+
+	const float ElapsedTime = static_cast<float>(GetWorld()->GetTimeSeconds() - TimedInteractionStartTime);
+	return FMath::Max(TimedInteractionDuration - ElapsedTime, 0.f);
+}
+
+void UInteractionQueueComponent::HandleTimedInteractionExpired(const uint32 TimerHandle)
+{
+	if (TimerHandle != TimedInteractionHandle)
+	{
+		return;
+	}
+
+	TimedInteractionHandle = 0;
+	FinishInteractionInternal();
+}
+
+void UInteractionQueueComponent::HandleReservationExpired(const AActor* InteractiveActor)
+{
+	if (!bHasActiveInteraction || ActiveInteractionActor != InteractiveActor)
+	{
+		return;
+	}
+
+	// The claim is already released, so only the active and timed state is left to clear
+	ClearActiveInteraction();
+}
+
+void UInteractionQueueComponent::RegisterCamera(UCameraComponent* Camera)
+{
+	if (!IsValid(Camera))
+	{
+		return;
+	}
+
+	if (IsValid(CameraComponent))
+	{
+		ActorsToIgnore.Remove(CameraComponent->GetOwner());
+	}
+
+	CameraComponent = Camera;
+	ActorsToIgnore.AddUnique(CameraComponent->GetOwner());
+	ViewPredictor.Reset();
+}
+
+void UInteractionQueueComponent::ApplyScalabilitySettings()
+{
+	SetComponentTickInterval(bPredictLineOfSight || bIsLineOfSightTraceStarved
+		                         ? 0.f
+		                         : FInteractionScalability::GetTickInterval());
+}
+
+void UInteractionQueueComponent::SortInteractionQueue()
+{
+	bIsSortPending = false;
+	TicksSinceSort = 0;
+
+	if (InteractionQueue.Num() <= 1)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_InteractionQueueSort);
+
+	auto Predicate = [](AActor* ActorA, AActor* ActorB) -> bool
+	{
+		return GetInteractionSortWeight(ActorA) >= GetInteractionSortWeight(ActorB);
+	};
+
+	Algo::Sort(InteractionQueue, Predicate);
+	bIsAssetsPriorityUpdatePending = true;
+}
+
+int32 UInteractionQueueComponent::GetInteractionSortWeight(const AActor* Actor)
+{
+	const FInteractionData* InteractionData = UTrickyInteractionLibrary::FindActorInteractionData(Actor);
+
+	if (!InteractionData)
+	{
+		return -1;
+	}
+
+	return InteractionData->bRequiresLineOfSight ? -1 : InteractionData->InteractionWeight;
+}
+
+void UInteractionQueueComponent::FlushPendingEvents()
+{
+	bIsFlushRequested = false;
+	SortInteractionQueueIfPending();
+
+	// Listeners may mutate the queue, their events are recorded into PendingEvents and flushed next frame
+	Swap(PendingEvents, DispatchingEvents);
+
+	for (const FInteractionQueueEvent& Event : DispatchingEvents)
+	{
+		BroadcastEvent(Event);
+	}
+
+	DispatchingEvents.Reset();
+	BroadcastHeadChangeIfNeeded();
+	UpdateInteractionAssetsPriorities();
+	PublishSnapshot();
+}
+
+void UInteractionQueueComponent::SortInteractionQueueIfPending() const
+{
+	if (!bIsSortPending)
+	{
+		return;
+	}
 
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-	FString Result = "NONE";
-	GetInteractionResultName(InteractionResult, Result);
-	const FString Message = FString::Printf(
-		TEXT("%s forced interaction with %s. Result %s"), *OwnerName, *ActorName, *Result);
-	PrintLog(Message);
+	// The deferred sort doesn't change the logical state of the queue, so const accessors can complete it
+	const_cast<UInteractionQueueComponent*>(this)->SortInteractionQueue();
+}
+
+void UInteractionQueueComponent::SortInteractionQueueOnTick()
+{
+	if (++TicksSinceSort >= FInteractionScalability::GetSortInterval())
+	{
+		SortInteractionQueue();
+	}
+}
+
+void UInteractionQueueComponent::UpdateInteractionQueueHead()
+{
+	if (IsEventDispatchDeferred())
+	{
+		RequestEventsFlush();
+		return;
+	}
+
+	BroadcastHeadChangeIfNeeded();
+	UpdateInteractionAssetsPriorities();
+	PublishSnapshot();
+}
+
+void UInteractionQueueComponent::BroadcastHeadChangeIfNeeded()
+{
+	AActor* NewHead = GetInteractionQueueHead();
+
+	if (NewHead == InteractionQueueHead)
+	{
+		return;
+	}
+
+	AActor* PreviousHead = InteractionQueueHead;
+	InteractionQueueHead = NewHead;
+	bIsAssetsPriorityUpdatePending = true;
+	BroadcastHeadChanged(NewHead, PreviousHead);
+}
+
+void UInteractionQueueComponent::PublishSnapshot()
+{
+	FInteractionQueueSnapshot Snapshot;
+	Snapshot.Head = GetInteractionQueueHead();
+	Snapshot.ActorInSight = ActorInSight;
+	Snapshot.QueueNum = InteractionQueue.Num();
+	Snapshot.QueueKeysNum = FMath::Min(InteractionQueue.Num(), FInteractionQueueSnapshot::MaxQueueKeys);
+	Snapshot.FrameNumber = GFrameCounter;
+
+	for (int32 i = 0; i < Snapshot.QueueKeysNum; ++i)
+	{
+		Snapshot.QueueKeys[i] = InteractionQueue[i];
+	}
+
+	SnapshotBuffer->Publish(Snapshot);
+
+#if WITH_EDITORONLY_DATA
+	EditorInteractionQueue.Reset();
+	EditorInteractionQueue.Append(InteractionQueue);
 #endif
+}
 
-	return InteractionResult;
+void UInteractionQueueComponent::StartTimedInteractionTimer(const float Duration)
+{
+	UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem();
+
+	if (Duration <= 0.f || !IsValid(Subsystem))
+	{
+		return;
+	}
+
+	TimedInteractionHandle = Subsystem->ScheduleTimedInteraction(this, Duration);
+	TimedInteractionStartTime = GetWorld()->GetTimeSeconds();
+	TimedInteractionDuration = Duration;
 }
 
-void UInteractionQueueComponent::RegisterCamera(UCameraComponent* Camera)
+void UInteractionQueueComponent::ClearActiveInteraction()
 {
-	if (!IsValid(Camera))
+	UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem();
+
+	if (Subsystem && ActiveInteractionActor)
+	{
+		Subsystem->ReleaseInteraction(ActiveInteractionActor, this);
+	}
+
+	if (Subsystem && TimedInteractionHandle != 0)
+	{
+		Subsystem->CancelTimedInteraction(TimedInteractionHandle);
+	}
+
+	ActiveInteractionActor = nullptr;
+	bHasActiveInteraction = false;
+	TimedInteractionHandle = 0;
+}
+
+AActor* UInteractionQueueComponent::GetActiveInteractionTarget()
+{
+	if (!bHasActiveInteraction)
+	{
+		return InteractionQueue[0];
+	}
+
+	if (!IsValid(ActiveInteractionActor))
+	{
+		// The started interaction can't be finished with another actor, so it's dropped instead
+		ClearActiveInteraction();
+		return nullptr;
+	}
+
+	return ActiveInteractionActor;
+}
+
+UTrickyInteractionSubsystem* UInteractionQueueComponent::GetInteractionSubsystem() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetSubsystem<UTrickyInteractionSubsystem>() : nullptr;
+}
+
+void UInteractionQueueComponent::RequestInteractionAssets(AActor* InteractiveActor)
+{
+	UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem();
+
+	if (!bPrefetchInteractionAssets || !Subsystem || InteractionAssetRequests.Contains(InteractiveActor))
 	{
 		return;
 	}
 
-	if (IsValid(CameraComponent))
+	// Covers the definitions, the inline InteractionData properties and the interactable components
+	const FInteractionData* InteractionData = UTrickyInteractionLibrary::FindActorInteractionData(InteractiveActor);
+
+	if (!InteractionData || InteractionData->InteractionAssets.IsEmpty())
 	{
-		ActorsToIgnore.Remove(CameraComponent->GetOwner());
+		return;
 	}
 
-	CameraComponent = Camera;
-	ActorsToIgnore.AddUnique(CameraComponent->GetOwner());
+	TArray<FSoftObjectPath> AssetPaths;
+	AssetPaths.Reserve(InteractionData->InteractionAssets.Num());
+
+	for (const TSoftObjectPtr<UObject>& Asset : InteractionData->InteractionAssets)
+	{
+		if (!Asset.IsNull())
+		{
+			AssetPaths.Add(Asset.ToSoftObjectPath());
+		}
+	}
+
+	if (AssetPaths.IsEmpty())
+	{
+		return;
+	}
+
+	FInteractionAssetsRequest Request;
+	Request.Priority = GetInteractionAssetsPriority(InteractiveActor);
+	Request.Handle = Subsystem->GetStreamableManager().RequestAsyncLoad(MoveTemp(AssetPaths),
+	                                                                    FStreamableDelegate(),
+	                                                                    Request.Priority);
+
+	if (Request.Handle.IsValid())
+	{
+		InteractionAssetRequests.Add(InteractiveActor, MoveTemp(Request));
+	}
 }
 
-void UInteractionQueueComponent::SortInteractionQueue()
+void UInteractionQueueComponent::ReleaseInteractionAssets(AActor* InteractiveActor)
 {
-	if (InteractionQueue.Num() <= 1)
+	FInteractionAssetsRequest Request;
+
+	if (InteractionAssetRequests.RemoveAndCopyValue(InteractiveActor, Request) && Request.Handle.IsValid())
+	{
+		Request.Handle->ReleaseHandle();
+	}
+}
+
+TAsyncLoadPriority UInteractionQueueComponent::GetInteractionAssetsPriority(const AActor* InteractiveActor) const
+{
+	const int32 QueueIndex = FMath::Max(InteractionQueue.IndexOfByKey(InteractiveActor), 0);
+	return FStreamableManager::AsyncLoadHighPriority
+		- FMath::Min<TAsyncLoadPriority>(QueueIndex, FStreamableManager::AsyncLoadHighPriority);
+}
+
+void UInteractionQueueComponent::UpdateInteractionAssetsPriorities()
+{
+	UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem();
+
+	if (!bIsAssetsPriorityUpdatePending || InteractionAssetRequests.IsEmpty() || !Subsystem)
 	{
 		return;
 	}
 
-	auto Predicate = [](AActor* ActorA, AActor* ActorB) -> bool
+	bIsAssetsPriorityUpdatePending = false;
+
+	for (TPair<TObjectKey<AActor>, FInteractionAssetsRequest>& Pair : InteractionAssetRequests)
 	{
-		FInteractionData InteractionDataA;
-		UTrickyInteractionLibrary::GetActorInteractionData(ActorA, InteractionDataA);
-		const int32 WeightA = InteractionDataA.bRequiresLineOfSight ? -1 : InteractionDataA.InteractionWeight;
+		FInteractionAssetsRequest& Request = Pair.Value;
+		const TAsyncLoadPriority Priority = GetInteractionAssetsPriority(Pair.Key.ResolveObjectPtr());
 
-		FInteractionData InteractionDataB;
-		UTrickyInteractionLibrary::GetActorInteractionData(ActorB, InteractionDataB);
-		const int32 WeightB = InteractionDataB.bRequiresLineOfSight ? -1 : InteractionDataB.InteractionWeight;
+		if (Priority == Request.Priority || !Request.Handle->IsLoadingInProgress())
+		{
+			continue;
+		}
 
-		return WeightA >= WeightB;
-	};
+		// The streamable manager can't change the priority of a request, so the assets are requested again
+		// and the old handle is released after the new one holds them
+		TArray<FSoftObjectPath> AssetPaths;
+		Request.Handle->GetRequestedAssets(AssetPaths);
+		TSharedPtr<FStreamableHandle> Handle = Subsystem->GetStreamableManager().RequestAsyncLoad(
+			MoveTemp(AssetPaths),
+			FStreamableDelegate(),
+			Priority);
 
-	Algo::Sort(InteractionQueue, Predicate);
+		if (!Handle.IsValid())
+		{
+			continue;
+		}
+
+		Request.Handle->ReleaseHandle();
+		Request.Handle = MoveTemp(Handle);
+		Request.Priority = Priority;
+	}
+}
+
+bool UInteractionQueueComponent::IsEventDispatchDeferred() const
+{
+	return bDeferEventDispatch && IsValid(GetInteractionSubsystem());
+}
+
+void UInteractionQueueComponent::RequestEventsFlush()
+{
+	if (bIsFlushRequested)
+	{
+		return;
+	}
+
+	UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem();
+
+	if (!IsValid(Subsystem))
+	{
+		// Nothing would flush the events, so they're broadcast right away instead of piling up
+		if (DispatchingEvents.IsEmpty())
+		{
+			FlushPendingEvents();
+		}
+
+		return;
+	}
+
+	bIsFlushRequested = true;
+	Subsystem->RequestEventsFlush(this);
+}
+
+void UInteractionQueueComponent::DispatchEvent(const FInteractionQueueEvent& Event)
+{
+	if (!IsEventDispatchDeferred())
+	{
+		BroadcastEvent(Event);
+		return;
+	}
+
+	using EType = FInteractionQueueEvent::EType;
+
+	if (Event.Type == EType::ActorAdded || Event.Type == EType::ActorRemoved)
+	{
+		const EType OppositeType = Event.Type == EType::ActorAdded ? EType::ActorRemoved : EType::ActorAdded;
+		auto IsOppositeEvent = [&Event, OppositeType](const FInteractionQueueEvent& PendingEvent)
+		{
+			return PendingEvent.Type == OppositeType && PendingEvent.InteractiveActor == Event.InteractiveActor;
+		};
+
+		const int32 OppositeIndex = PendingEvents.FindLastByPredicate(IsOppositeEvent);
+
+		if (OppositeIndex != INDEX_NONE)
+		{
+			PendingEvents.RemoveAt(OppositeIndex, 1, EAllowShrinking::No);
+			RequestEventsFlush();
+			return;
+		}
+	}
+
+	const int32 PreviousEventsMax = PendingEvents.Max();
+	PendingEvents.Add(Event);
+	FInteractionPerfCounters::ContainerAllocationsNum += PendingEvents.Max() != PreviousEventsMax ? 1 : 0;
+	RequestEventsFlush();
+}
+
+void UInteractionQueueComponent::BroadcastEvent(const FInteractionQueueEvent& Event)
+{
+	// Actors destroyed during the frame are still reported to the listeners
+	AActor* InteractiveActor = Event.InteractiveActor.Get(true);
+
+	switch (Event.Type)
+	{
+	case FInteractionQueueEvent::EType::ActorAdded:
+		BroadcastActorAdded(InteractiveActor);
+		break;
+
+	case FInteractionQueueEvent::EType::ActorRemoved:
+		BroadcastActorRemoved(InteractiveActor);
+		break;
+
+	case FInteractionQueueEvent::EType::InteractionStarted:
+		BroadcastInteractionStarted(InteractiveActor, Event.InteractionResult);
+		break;
+
+	case FInteractionQueueEvent::EType::InteractionFinished:
+		BroadcastInteractionFinished(InteractiveActor, Event.InteractionResult);
+		break;
+
+	case FInteractionQueueEvent::EType::InteractionInterrupted:
+		BroadcastInteractionInterrupted(InteractiveActor, Event.Interruptor.Get(true), Event.InteractionResult);
+		break;
+
+	case FInteractionQueueEvent::EType::InteractionForced:
+		BroadcastInteractionForced(InteractiveActor, Event.InteractionResult);
+		break;
+	}
+}
+
+void UInteractionQueueComponent::BroadcastActorAdded(AActor* InteractiveActor)
+{
+	SCOPE_CYCLE_COUNTER(STAT_InteractionBroadcastEvents);
+	OnActorAddedToInteractionQueueNative.Broadcast(this, InteractiveActor);
+
+	if (OnActorAddedToInteractionQueue.IsBound())
+	{
+		OnActorAddedToInteractionQueue.Broadcast(this, InteractiveActor);
+	}
+}
+
+void UInteractionQueueComponent::BroadcastActorRemoved(AActor* InteractiveActor)
+{
+	SCOPE_CYCLE_COUNTER(STAT_InteractionBroadcastEvents);
+	OnActorRemovedFromInteractionQueueNative.Broadcast(this, InteractiveActor);
+
+	if (OnActorRemovedFromInteractionQueue.IsBound())
+	{
+		OnActorRemovedFromInteractionQueue.Broadcast(this, InteractiveActor);
+	}
+}
+
+void UInteractionQueueComponent::BroadcastInteractionStarted(AActor* InteractiveActor,
+                                                             const EInteractionResult InteractionResult)
+{
+	SCOPE_CYCLE_COUNTER(STAT_InteractionBroadcastEvents);
+	OnInteractionStartedNative.Broadcast(this, InteractiveActor, InteractionResult);
+
+	if (OnInteractionStarted.IsBound())
+	{
+		OnInteractionStarted.Broadcast(this, InteractiveActor, InteractionResult);
+	}
+}
+
+void UInteractionQueueComponent::BroadcastInteractionFinished(AActor* InteractiveActor,
+                                                              const EInteractionResult InteractionResult)
+{
+	SCOPE_CYCLE_COUNTER(STAT_InteractionBroadcastEvents);
+	OnInteractionFinishedNative.Broadcast(this, InteractiveActor, InteractionResult);
+
+	if (OnInteractionFinished.IsBound())
+	{
+		OnInteractionFinished.Broadcast(this, InteractiveActor, InteractionResult);
+	}
+}
+
+void UInteractionQueueComponent::BroadcastInteractionInterrupted(AActor* InteractiveActor,
+                                                                 AActor* Interruptor,
+                                                                 const EInteractionResult InteractionResult)
+{
+	SCOPE_CYCLE_COUNTER(STAT_InteractionBroadcastEvents);
+	OnInteractionInterruptedNative.Broadcast(this, InteractiveActor, Interruptor, InteractionResult);
+
+	if (OnInteractionInterrupted.IsBound())
+	{
+		OnInteractionInterrupted.Broadcast(this, InteractiveActor, Interruptor, InteractionResult);
+	}
+}
+
+void UInteractionQueueComponent::BroadcastInteractionForced(AActor* InteractiveActor,
+                                                            const EInteractionResult InteractionResult)
+{
+	SCOPE_CYCLE_COUNTER(STAT_InteractionBroadcastEvents);
+	OnInteractionForcedNative.Broadcast(this, InteractiveActor, InteractionResult);
+
+	if (OnInteractionForced.IsBound())
+	{
+		OnInteractionForced.Broadcast(this, InteractiveActor, InteractionResult);
+	}
+}
+
+void UInteractionQueueComponent::BroadcastHeadChanged(AActor* NewHead, AActor* PreviousHead)
+{
+	SCOPE_CYCLE_COUNTER(STAT_InteractionBroadcastEvents);
+	OnInteractionQueueHeadChangedNative.Broadcast(this, NewHead, PreviousHead);
+
+	if (OnInteractionQueueHeadChanged.IsBound())
+	{
+		OnInteractionQueueHeadChanged.Broadcast(this, NewHead, PreviousHead);
+	}
 }
 
 void UInteractionQueueComponent::ToggleComponentTick()
@@ -362,7 +1762,31 @@ void UInteractionQueueComponent::ToggleComponentTick()
 	SetComponentTickEnabled(bUseLineOfSight && !IsInteractionQueueEmpty() && !IsComponentTickEnabled());
 }
 
-void UInteractionQueueComponent::CheckLineOfSight(const float DeltaTime, FHitResult& OutHitResult) const
+bool UInteractionQueueComponent::GetLineOfSightView(const float DeltaTime,
+                                                    FVector& OutLocation,
+                                                    FQuat& OutRotation) const
+{
+	if (!IsValid(CameraComponent))
+	{
+		return false;
+	}
+
+	if (bPredictLineOfSight)
+	{
+		// The result is used until the next check, so the view is predicted into that interval
+		const float LookAhead = FInteractionScalability::GetTickInterval() * LineOfSightPredictionFactor;
+		ViewPredictor.Predict(LookAhead, OutLocation, OutRotation);
+		return true;
+	}
+
+	FMinimalViewInfo ViewInfo;
+	CameraComponent->GetCameraView(DeltaTime, ViewInfo);
+	OutLocation = ViewInfo.Location;
+	OutRotation = ViewInfo.Rotation.Quaternion();
+	return true;
+}
+
+void UInteractionQueueComponent::SampleLineOfSightView(const float DeltaTime)
 {
 	if (!IsValid(CameraComponent))
 	{
@@ -371,14 +1795,123 @@ void UInteractionQueueComponent::CheckLineOfSight(const float DeltaTime, FHitRes
 
 	FMinimalViewInfo ViewInfo;
 	CameraComponent->GetCameraView(DeltaTime, ViewInfo);
+	ViewPredictor.AddSample(ViewInfo.Location, ViewInfo.Rotation.Quaternion(), GetWorld()->GetTimeSeconds());
+}
+
+void UInteractionQueueComponent::GetCurrentLineOfSightView(FVector& OutLocation, FQuat& OutRotation) const
+{
+	if (!IsValid(CameraComponent))
+	{
+		OutLocation = FVector::ZeroVector;
+		OutRotation = FQuat::Identity;
+		return;
+	}
+
+	FMinimalViewInfo ViewInfo;
+	CameraComponent->GetCameraView(0.f, ViewInfo);
+	OutLocation = ViewInfo.Location;
+	OutRotation = ViewInfo.Rotation.Quaternion();
+}
+
+bool UInteractionQueueComponent::IsInLineOfSight(AActor* InteractiveActor, bool& bOutIsOverTraceBudget)
+{
+	bOutIsOverTraceBudget = false;
+
+	if (InteractiveActor == ActorInSight)
+	{
+		return true;
+	}
+
+	if (!bPredictLineOfSight || !IsValid(CameraComponent))
+	{
+		return false;
+	}
+
+	// The re-validation trace shares the per frame budget with the line of sight ticks
+	UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem();
+
+	if (Subsystem && !Subsystem->TryConsumeTraceBudget(this))
+	{
+		bOutIsOverTraceBudget = true;
+		return false;
+	}
+
+	// The prediction may have missed a fast flick, the current view decides
+	INC_DWORD_STAT(STAT_InteractionRevalidations);
+	FVector ViewLocation = FVector::ZeroVector;
+	FQuat ViewRotation = FQuat::Identity;
+	GetCurrentLineOfSightView(ViewLocation, ViewRotation);
+
+	FHitResult HitResult;
+	CheckLineOfSight(ViewLocation, ViewRotation.GetForwardVector(), HitResult);
+
+	if (!HitResult.bBlockingHit || HitResult.GetActor() != InteractiveActor)
+	{
+		return false;
+	}
+
+	ActorInSight = InteractiveActor;
+	PublishSnapshot();
+	return true;
+}
+
+void UInteractionQueueComponent::CheckLineOfSight(const FVector& ViewLocation,
+                                                  const FVector& ViewDirection,
+                                                  FHitResult& OutHitResult) const
+{
+	const FVector StartPoint = ViewLocation;
+	const float TraceDistance = LineOfSightDistance * FInteractionScalability::GetTraceDistanceScale();
+	const float TraceRadius = LineOfSightRadius * FInteractionScalability::GetTraceRadiusScale();
+	const FVector EndPoint = ViewLocation + ViewDirection * TraceDistance;
+
+	UTrickyInteractionSubsystem* Subsystem = GetInteractionSubsystem();
+
+	if (LineOfSightBackend == ELineOfSightBackend::InteractiveBounds && Subsystem)
+	{
+		FVector HitLocation = FVector::ZeroVector;
+		AActor* Candidate = Subsystem->RaycastInteractiveBounds(StartPoint,
+		                                                        EndPoint,
+		                                                        TraceRadius,
+		                                                        ActorsToIgnore,
+		                                                        HitLocation);
+
+		if (!Candidate)
+		{
+			return;
+		}
+
+		++FInteractionPerfCounters::TracesNum;
+
+		// The candidate is picked by its bounds, so the line to it is checked for occluders
+		UKismetSystemLibrary::LineTraceSingle(GetOwner(),
+		                                      StartPoint,
+		                                      HitLocation,
+		                                      TraceChannel,
+		                                      false,
+		                                      ActorsToIgnore,
+		                                      DrawDebugType,
+		                                      OutHitResult,
+		                                      true,
+		                                      TraceColor,
+		                                      TraceHitColor,
+		                                      DrawTime);
+
+		if (!OutHitResult.bBlockingHit || OutHitResult.GetActor() == Candidate)
+		{
+			OutHitResult = FHitResult(Candidate, nullptr, HitLocation, (StartPoint - EndPoint).GetSafeNormal());
+			OutHitResult.bBlockingHit = true;
+			OutHitResult.TraceStart = StartPoint;
+			OutHitResult.TraceEnd = EndPoint;
+		}
 
-	const FVector StartPoint = ViewInfo.Location;
-	const FVector EndPoint = ViewInfo.Location + ViewInfo.Rotation.Vector() * LineOfSightDistance;
+		return;
+	}
 
+	++FInteractionPerfCounters::TracesNum;
 	UKismetSystemLibrary::SphereTraceSingle(GetOwner(),
 	                                        StartPoint,
 	                                        EndPoint,
-	                                        LineOfSightRadius,
+	                                        TraceRadius,
 	                                        TraceChannel,
 	                                        false,
 	                                        ActorsToIgnore,
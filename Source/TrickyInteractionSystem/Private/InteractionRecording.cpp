@@ -0,0 +1,742 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractionRecording.h"
+
+#include "EngineUtils.h"
+#include "InteractionQueueComponent.h"
+#include "TrickyInteractionInterface.h"
+#include "TrickyInteractionSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+
+void FInteractionRecordingFormat::WriteVarint(TArray<uint8>& Buffer, uint64 Value)
+{
+	while (Value >= 0x80)
+	{
+		Buffer.Add(static_cast<uint8>(Value | 0x80));
+		Value >>= 7;
+	}
+
+	Buffer.Add(static_cast<uint8>(Value));
+}
+
+bool FInteractionRecordingFormat::ReadVarint(TConstArrayView<uint8> Data, int32& Offset, uint64& OutValue)
+{
+	OutValue = 0;
+
+	for (int32 Shift = 0; Shift < 64 && Data.IsValidIndex(Offset); Shift += 7)
+	{
+		const uint8 Byte = Data[Offset++];
+		OutValue |= static_cast<uint64>(Byte & 0x7F) << Shift;
+
+		if ((Byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void FInteractionRecordingFormat::WriteName(TArray<uint8>& Buffer, const FName Name)
+{
+	const FTCHARToUTF8 Converted(*Name.ToString());
+	WriteVarint(Buffer, Converted.Length());
+	Buffer.Append(reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length());
+}
+
+bool FInteractionRecordingFormat::ReadName(TConstArrayView<uint8> Data, int32& Offset, FName& OutName)
+{
+	uint64 Length = 0;
+
+	if (!ReadVarint(Data, Offset, Length) || Length > static_cast<uint64>(Data.Num() - Offset))
+	{
+		return false;
+	}
+
+	const FUTF8ToTCHAR Converted(reinterpret_cast<const UTF8CHAR*>(Data.GetData() + Offset),
+	                             static_cast<int32>(Length));
+	OutName = FName(Converted.Length(), Converted.Get());
+	Offset += static_cast<int32>(Length);
+	return true;
+}
+
+void FInteractionRecordingFormat::WriteFloat(TArray<uint8>& Buffer, const float Value)
+{
+	Buffer.Append(reinterpret_cast<const uint8*>(&Value), sizeof(float));
+}
+
+bool FInteractionRecordingFormat::ReadFloat(TConstArrayView<uint8> Data, int32& Offset, float& OutValue)
+{
+	if (Offset < 0 || Data.Num() - Offset < static_cast<int32>(sizeof(float)))
+	{
+		return false;
+	}
+
+	FMemory::Memcpy(&OutValue, Data.GetData() + Offset, sizeof(float));
+	Offset += sizeof(float);
+	return true;
+}
+
+FInteractionRecorder::~FInteractionRecorder()
+{
+	Stop();
+}
+
+bool FInteractionRecorder::Start(UTrickyInteractionSubsystem* InSubsystem, const FString& Filename)
+{
+	if (IsRecording() || !IsValid(InSubsystem))
+	{
+		return false;
+	}
+
+	FileWriter.Reset(IFileManager::Get().CreateFileWriter(*Filename));
+
+	if (!FileWriter.IsValid())
+	{
+		return false;
+	}
+
+	Subsystem = InSubsystem;
+	ObjectIds.Reset();
+	Buffer.Reset();
+	LastFrame = GFrameCounter;
+	RecordsNum = 0;
+	BytesWritten = 0;
+
+	uint32 Magic = FileMagic;
+	uint32 Version = FileVersion;
+	*FileWriter << Magic;
+	*FileWriter << Version;
+	BytesWritten = FileWriter->Tell();
+
+	TArray<UInteractionQueueComponent*> Components;
+	InSubsystem->GetQueueComponents(Components);
+
+	for (UInteractionQueueComponent* Component : Components)
+	{
+		BindComponent(InSubsystem, Component);
+	}
+
+	ComponentRegisteredHandle = InSubsystem->OnQueueComponentRegistered.AddRaw(
+		this, &FInteractionRecorder::BindComponent);
+	return true;
+}
+
+void FInteractionRecorder::Stop()
+{
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	if (UTrickyInteractionSubsystem* CurrentSubsystem = Subsystem.Get())
+	{
+		CurrentSubsystem->OnQueueComponentRegistered.Remove(ComponentRegisteredHandle);
+	}
+
+	for (const TWeakObjectPtr<UInteractionQueueComponent>& WeakComponent : BoundComponents)
+	{
+		UInteractionQueueComponent* Component = WeakComponent.Get();
+
+		if (!Component)
+		{
+			continue;
+		}
+
+		Component->OnInteractionQueueCallNative.RemoveAll(this);
+	}
+
+	FlushBuffer();
+	FileWriter->Close();
+	FileWriter.Reset();
+	BoundComponents.Empty();
+	ObjectIds.Empty();
+	ComponentRegisteredHandle.Reset();
+	Subsystem.Reset();
+}
+
+void FInteractionRecorder::BindComponent(UTrickyInteractionSubsystem* InSubsystem, UInteractionQueueComponent* Component)
+{
+	if (!IsValid(Component))
+	{
+		return;
+	}
+
+	Component->OnInteractionQueueCallNative.AddRaw(this, &FInteractionRecorder::HandleCall);
+	BoundComponents.Emplace(Component);
+}
+
+void FInteractionRecorder::HandleCall(UInteractionQueueComponent* Component, const FInteractionQueueCall& Call)
+{
+	const UTrickyInteractionSubsystem* CurrentSubsystem = Subsystem.Get();
+
+	// The deferred adds are replayed by the add calls which deferred them
+	if (CurrentSubsystem && CurrentSubsystem->IsProcessingDeferredQueueAdds())
+	{
+		return;
+	}
+
+	// Ids are resolved first, so the definitions are written before the call which uses them
+	const uint32 ComponentId = GetComponentId(Component);
+	TArray<uint32, TInlineAllocator<16>> ActorIds;
+	EInteractionRecordType Type = EInteractionRecordType::Max;
+
+	switch (Call.Type)
+	{
+	case FInteractionQueueCall::EType::Add:
+		Type = EInteractionRecordType::AddCall;
+		ActorIds.Add(GetActorId(Call.InteractiveActor));
+		break;
+
+	case FInteractionQueueCall::EType::Remove:
+		Type = EInteractionRecordType::RemoveCall;
+		ActorIds.Add(GetActorId(Call.InteractiveActor));
+		break;
+
+	case FInteractionQueueCall::EType::AddBatch:
+	case FInteractionQueueCall::EType::RemoveBatch:
+		Type = Call.Type == FInteractionQueueCall::EType::AddBatch
+			       ? EInteractionRecordType::AddBatchCall
+			       : EInteractionRecordType::RemoveBatchCall;
+
+		for (AActor* InteractiveActor : Call.InteractiveActors)
+		{
+			ActorIds.Add(GetActorId(InteractiveActor));
+		}
+		break;
+
+	case FInteractionQueueCall::EType::Start:
+		Type = EInteractionRecordType::StartCall;
+		ActorIds.Add(GetActorId(Call.InteractiveActor));
+		break;
+
+	case FInteractionQueueCall::EType::StartTimed:
+		Type = EInteractionRecordType::StartTimedCall;
+		ActorIds.Add(GetActorId(Call.InteractiveActor));
+		break;
+
+	case FInteractionQueueCall::EType::Finish:
+		Type = EInteractionRecordType::FinishCall;
+		break;
+
+	case FInteractionQueueCall::EType::Interrupt:
+		Type = EInteractionRecordType::InterruptCall;
+		ActorIds.Add(GetActorId(Call.Interruptor));
+		break;
+
+	case FInteractionQueueCall::EType::Force:
+		Type = EInteractionRecordType::ForceCall;
+		ActorIds.Add(GetActorId(Call.InteractiveActor));
+		break;
+
+	default:
+		return;
+	}
+
+	BeginRecord(Type);
+	FInteractionRecordingFormat::WriteVarint(Buffer, ComponentId);
+
+	if (Type == EInteractionRecordType::AddBatchCall || Type == EInteractionRecordType::RemoveBatchCall)
+	{
+		FInteractionRecordingFormat::WriteVarint(Buffer, ActorIds.Num());
+	}
+
+	for (const uint32 ActorId : ActorIds)
+	{
+		FInteractionRecordingFormat::WriteVarint(Buffer, ActorId);
+	}
+
+	if (Type == EInteractionRecordType::StartTimedCall)
+	{
+		FInteractionRecordingFormat::WriteFloat(Buffer, Call.Duration);
+	}
+
+	FInteractionRecordingFormat::WriteVarint(Buffer, FMath::Max(Call.Result, 0));
+
+	if (Buffer.Num() >= FlushThreshold)
+	{
+		FlushBuffer();
+	}
+}
+
+uint32 FInteractionRecorder::GetActorId(AActor* Actor)
+{
+	if (!Actor)
+	{
+		return 0;
+	}
+
+	if (const uint32* Id = ObjectIds.Find(Actor))
+	{
+		return *Id;
+	}
+
+	const uint32 Id = ObjectIds.Num() + 1;
+	ObjectIds.Add(Actor, Id);
+
+	BeginRecord(EInteractionRecordType::DefineActor);
+	FInteractionRecordingFormat::WriteVarint(Buffer, Id);
+	FInteractionRecordingFormat::WriteName(Buffer, Actor->GetFName());
+	return Id;
+}
+
+uint32 FInteractionRecorder::GetComponentId(UInteractionQueueComponent* Component)
+{
+	if (!Component)
+	{
+		return 0;
+	}
+
+	if (const uint32* Id = ObjectIds.Find(Component))
+	{
+		return *Id;
+	}
+
+	const uint32 OwnerId = GetActorId(Component->GetOwner());
+	const uint32 Id = ObjectIds.Num() + 1;
+	ObjectIds.Add(Component, Id);
+
+	BeginRecord(EInteractionRecordType::DefineComponent);
+	FInteractionRecordingFormat::WriteVarint(Buffer, Id);
+	FInteractionRecordingFormat::WriteVarint(Buffer, OwnerId);
+	FInteractionRecordingFormat::WriteName(Buffer, Component->GetFName());
+	return Id;
+}
+
+void FInteractionRecorder::BeginRecord(const EInteractionRecordType Type)
+{
+	FInteractionRecordingFormat::WriteVarint(Buffer, GFrameCounter - LastFrame);
+	Buffer.Add(static_cast<uint8>(Type));
+	LastFrame = GFrameCounter;
+	++RecordsNum;
+}
+
+void FInteractionRecorder::FlushBuffer()
+{
+	if (!FileWriter.IsValid() || Buffer.IsEmpty())
+	{
+		return;
+	}
+
+	FileWriter->Serialize(Buffer.GetData(), Buffer.Num());
+	BytesWritten += Buffer.Num();
+	Buffer.Reset();
+}
+
+FInteractionReplayer::~FInteractionReplayer()
+{
+	Stop();
+}
+
+bool FInteractionReplayer::Start(UWorld* InWorld, const FString& Filename)
+{
+	Stop();
+
+	if (!IsValid(InWorld) || !FFileHelper::LoadFileToArray(Data, *Filename))
+	{
+		return false;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+
+	if (Data.Num() < static_cast<int32>(sizeof(uint32) * 2))
+	{
+		Data.Empty();
+		return false;
+	}
+
+	FMemory::Memcpy(&Magic, Data.GetData(), sizeof(uint32));
+	FMemory::Memcpy(&Version, Data.GetData() + sizeof(uint32), sizeof(uint32));
+
+	if (Magic != FInteractionRecorder::FileMagic || Version > FInteractionRecorder::FileVersion)
+	{
+		Data.Empty();
+		return false;
+	}
+
+	World = InWorld;
+	ReadOffset = sizeof(uint32) * 2;
+	StartFrame = GFrameCounter;
+	NextRecordFrame = 0;
+	bIsRecordFrameRead = false;
+	Objects.SetNum(1);
+	CacheActorNames();
+	ActorSpawnedHandle = InWorld->AddOnActorSpawnedHandler(
+		FOnActorSpawned::FDelegate::CreateRaw(this, &FInteractionReplayer::HandleActorSpawned));
+	return true;
+}
+
+void FInteractionReplayer::Stop()
+{
+	if (UWorld* CurrentWorld = World.Get())
+	{
+		CurrentWorld->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+
+	ActorSpawnedHandle.Reset();
+	World.Reset();
+	Data.Empty();
+	ReadOffset = 0;
+	Objects.Empty();
+	ActorsByName.Empty();
+	RecordsNum = 0;
+	DivergencesNum = 0;
+	UnresolvedNum = 0;
+}
+
+bool FInteractionReplayer::Tick()
+{
+	const uint64 CurrentFrame = GFrameCounter - StartFrame;
+
+	while (IsReplaying())
+	{
+		if (!bIsRecordFrameRead)
+		{
+			uint64 FrameDelta = 0;
+
+			if (!FInteractionRecordingFormat::ReadVarint(Data, ReadOffset, FrameDelta))
+			{
+				break;
+			}
+
+			NextRecordFrame += FrameDelta;
+			bIsRecordFrameRead = true;
+		}
+
+		if (NextRecordFrame > CurrentFrame)
+		{
+			return true;
+		}
+
+		bIsRecordFrameRead = false;
+
+		if (!Data.IsValidIndex(ReadOffset)
+			|| Data[ReadOffset] >= static_cast<uint8>(EInteractionRecordType::Max)
+			|| !ApplyRecord(static_cast<EInteractionRecordType>(Data[ReadOffset++])))
+		{
+			// The rest of a truncated or corrupted recording is skipped
+			ReadOffset = Data.Num();
+		}
+	}
+
+	return false;
+}
+
+bool FInteractionReplayer::ApplyRecord(const EInteractionRecordType Type)
+{
+	++RecordsNum;
+	uint32 Id = 0;
+
+	if (Type == EInteractionRecordType::DefineActor || Type == EInteractionRecordType::DefineComponent)
+	{
+		FRecordedObject Object;
+
+		if (!ReadId(Id)
+			|| (Type == EInteractionRecordType::DefineComponent && !ReadId(Object.OwnerId))
+			|| !FInteractionRecordingFormat::ReadName(Data, ReadOffset, Object.Name)
+			|| Id != static_cast<uint32>(Objects.Num()))
+		{
+			return false;
+		}
+
+		// Ids are assigned sequentially by the recorder
+		Objects.Add(Object);
+		return true;
+	}
+
+	if (!ReadId(Id))
+	{
+		return false;
+	}
+
+	return Type >= EInteractionRecordType::AddCall ? ApplyCallRecord(Type, Id) : ApplyEventRecord(Type, Id);
+}
+
+bool FInteractionReplayer::ApplyEventRecord(const EInteractionRecordType Type, const uint32 ComponentId)
+{
+	uint32 ActorId = 0;
+	uint32 ExtraActorId = 0;
+
+	if (!ReadId(ActorId))
+	{
+		return false;
+	}
+
+	if ((Type == EInteractionRecordType::InteractionInterrupted || Type == EInteractionRecordType::QueueHeadChanged)
+		&& !ReadId(ExtraActorId))
+	{
+		return false;
+	}
+
+	EInteractionResult RecordedResult = EInteractionResult::Invalid;
+
+	if (Type != EInteractionRecordType::ActorAdded
+		&& Type != EInteractionRecordType::ActorRemoved
+		&& Type != EInteractionRecordType::QueueHeadChanged)
+	{
+		if (!Data.IsValidIndex(ReadOffset))
+		{
+			return false;
+		}
+
+		RecordedResult = static_cast<EInteractionResult>(Data[ReadOffset++]);
+	}
+
+	UInteractionQueueComponent* Component = ResolveComponent(ComponentId);
+	AActor* InteractiveActor = ResolveActor(ActorId);
+
+	if (!Component || (ActorId != 0 && !InteractiveActor))
+	{
+		++UnresolvedNum;
+		return true;
+	}
+
+	// Timed interactions and interruptions caused by removal happen on their own during the replay
+	const bool bHasActiveInteraction = Component->GetActiveInteractionActor() != nullptr;
+	EInteractionResult InteractionResult = RecordedResult;
+
+	switch (Type)
+	{
+	case EInteractionRecordType::ActorAdded:
+		Component->AddToInteractionQueue(InteractiveActor);
+		break;
+
+	case EInteractionRecordType::ActorRemoved:
+		Component->RemoveFromInteractionQueue(InteractiveActor);
+		break;
+
+	case EInteractionRecordType::InteractionStarted:
+		DivergencesNum += Component->GetInteractionTarget() != InteractiveActor ? 1 : 0;
+		InteractionResult = Component->StartInteraction();
+		break;
+
+	case EInteractionRecordType::InteractionFinished:
+		if (bHasActiveInteraction)
+		{
+			InteractionResult = Component->FinishInteraction();
+		}
+		break;
+
+	case EInteractionRecordType::InteractionInterrupted:
+		if (bHasActiveInteraction)
+		{
+			InteractionResult = Component->InterruptInteraction(ResolveActor(ExtraActorId));
+		}
+		break;
+
+	case EInteractionRecordType::InteractionForced:
+		DivergencesNum += Component->GetInteractionTarget() != InteractiveActor ? 1 : 0;
+		InteractionResult = Component->ForceInteraction();
+		break;
+
+	case EInteractionRecordType::QueueHeadChanged:
+		// Line of sight can't be replayed, so the head is only verified
+		DivergencesNum += Component->GetInteractionQueueHead() != InteractiveActor ? 1 : 0;
+		break;
+
+	default:
+		break;
+	}
+
+	DivergencesNum += InteractionResult != RecordedResult ? 1 : 0;
+	return true;
+}
+
+bool FInteractionReplayer::ApplyCallRecord(const EInteractionRecordType Type, const uint32 ComponentId)
+{
+	uint32 ActorsNum = Type == EInteractionRecordType::FinishCall ? 0 : 1;
+
+	if (Type == EInteractionRecordType::AddBatchCall || Type == EInteractionRecordType::RemoveBatchCall)
+	{
+		// Every id takes at least one byte, so a larger number means the data is corrupted
+		if (!ReadId(ActorsNum) || ActorsNum > static_cast<uint32>(Data.Num() - ReadOffset))
+		{
+			return false;
+		}
+	}
+
+	TArray<uint32, TInlineAllocator<16>> ActorIds;
+	ActorIds.SetNumUninitialized(ActorsNum);
+
+	for (uint32& ActorId : ActorIds)
+	{
+		if (!ReadId(ActorId))
+		{
+			return false;
+		}
+	}
+
+	float Duration = 0.f;
+	uint64 RecordedResult = 0;
+
+	if ((Type == EInteractionRecordType::StartTimedCall
+			&& !FInteractionRecordingFormat::ReadFloat(Data, ReadOffset, Duration))
+		|| !FInteractionRecordingFormat::ReadVarint(Data, ReadOffset, RecordedResult))
+	{
+		return false;
+	}
+
+	UInteractionQueueComponent* Component = ResolveComponent(ComponentId);
+	bool bIsResolved = Component != nullptr;
+	TArray<AActor*> Actors;
+	Actors.Reserve(ActorIds.Num());
+
+	for (const uint32 ActorId : ActorIds)
+	{
+		AActor* Actor = ResolveActor(ActorId);
+		bIsResolved &= ActorId == 0 || Actor != nullptr;
+		Actors.Add(Actor);
+	}
+
+	if (!bIsResolved)
+	{
+		++UnresolvedNum;
+		return true;
+	}
+
+	switch (Type)
+	{
+	case EInteractionRecordType::AddCall:
+		CompareResult(RecordedResult, Component->AddToInteractionQueue(Actors[0]) ? 1 : 0);
+		break;
+
+	case EInteractionRecordType::RemoveCall:
+		CompareResult(RecordedResult, Component->RemoveFromInteractionQueue(Actors[0]) ? 1 : 0);
+		break;
+
+	case EInteractionRecordType::AddBatchCall:
+		CompareResult(RecordedResult, static_cast<uint64>(Component->AddToInteractionQueueBatch(Actors)));
+		break;
+
+	case EInteractionRecordType::RemoveBatchCall:
+		CompareResult(RecordedResult, static_cast<uint64>(Component->RemoveFromInteractionQueueBatch(Actors)));
+		break;
+
+	case EInteractionRecordType::StartCall:
+		DivergencesNum += Component->GetInteractionTarget() != Actors[0] ? 1 : 0;
+		CompareResult(RecordedResult, static_cast<uint64>(Component->StartInteraction()));
+		break;
+
+	case EInteractionRecordType::StartTimedCall:
+		DivergencesNum += Component->GetInteractionTarget() != Actors[0] ? 1 : 0;
+		CompareResult(RecordedResult, static_cast<uint64>(Component->StartTimedInteraction(Duration)));
+		break;
+
+	case EInteractionRecordType::FinishCall:
+		CompareResult(RecordedResult, static_cast<uint64>(Component->FinishInteraction()));
+		break;
+
+	case EInteractionRecordType::InterruptCall:
+		CompareResult(RecordedResult, static_cast<uint64>(Component->InterruptInteraction(Actors[0])));
+		break;
+
+	case EInteractionRecordType::ForceCall:
+		DivergencesNum += Component->GetInteractionTarget() != Actors[0] ? 1 : 0;
+		CompareResult(RecordedResult, static_cast<uint64>(Component->ForceInteraction()));
+		break;
+
+	default:
+		break;
+	}
+
+	return true;
+}
+
+void FInteractionReplayer::CompareResult(const uint64 RecordedResult, const uint64 Result)
+{
+	DivergencesNum += RecordedResult != Result ? 1 : 0;
+}
+
+AActor* FInteractionReplayer::ResolveActor(const uint32 Id)
+{
+	if (Id == 0 || !Objects.IsValidIndex(Id) || Objects[Id].OwnerId != 0)
+	{
+		return nullptr;
+	}
+
+	FRecordedObject& Object = Objects[Id];
+
+	if (AActor* Actor = Cast<AActor>(Object.Object.Get()))
+	{
+		return Actor;
+	}
+
+	// Actors spawned after the replay started are added by HandleActorSpawned
+	const TWeakObjectPtr<AActor>* Actor = ActorsByName.Find(Object.Name);
+	Object.Object = Actor ? Actor->Get() : nullptr;
+	return Cast<AActor>(Object.Object.Get());
+}
+
+UInteractionQueueComponent* FInteractionReplayer::ResolveComponent(const uint32 Id)
+{
+	if (Id == 0 || !Objects.IsValidIndex(Id) || Objects[Id].OwnerId == 0)
+	{
+		return nullptr;
+	}
+
+	if (UInteractionQueueComponent* Component = Cast<UInteractionQueueComponent>(Objects[Id].Object.Get()))
+	{
+		return Component;
+	}
+
+	const AActor* Owner = ResolveActor(Objects[Id].OwnerId);
+
+	if (!Owner)
+	{
+		return nullptr;
+	}
+
+	TInlineComponentArray<UInteractionQueueComponent*> Components(Owner);
+
+	for (UInteractionQueueComponent* Component : Components)
+	{
+		if (Component->GetFName() == Objects[Id].Name)
+		{
+			Objects[Id].Object = Component;
+			return Component;
+		}
+	}
+
+	return nullptr;
+}
+
+void FInteractionReplayer::CacheActorNames()
+{
+	ActorsByName.Reset();
+
+	if (!World.IsValid())
+	{
+		return;
+	}
+
+	for (TActorIterator<AActor> It(World.Get()); It; ++It)
+	{
+		ActorsByName.Add(It->GetFName(), *It);
+	}
+}
+
+void FInteractionReplayer::HandleActorSpawned(AActor* Actor)
+{
+	if (IsValid(Actor))
+	{
+		ActorsByName.Add(Actor->GetFName(), Actor);
+	}
+}
+
+bool FInteractionReplayer::ReadId(uint32& OutId)
+{
+	uint64 Value = 0;
+
+	if (!FInteractionRecordingFormat::ReadVarint(Data, ReadOffset, Value) || Value > MAX_uint32)
+	{
+		return false;
+	}
+
+	OutId = static_cast<uint32>(Value);
+	return true;
+}
@@ -0,0 +1,177 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractionSavedState.h"
+
+#include "Engine/World.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+/**
+ * Converts an object path of the first version, which could carry the PIE prefix
+ */
+static FSoftObjectPath ConvertLegacyPath(const FSoftObjectPath& Path)
+{
+	return FSoftObjectPath(UWorld::RemovePIEPrefix(Path.ToString()));
+}
+
+FArchive& operator<<(FArchive& Ar, FInteractionActorId& ActorId)
+{
+	Ar << ActorId.Guid;
+	Ar << ActorId.Path;
+	return Ar;
+}
+
+void FInteractionQueueSavedState::Write(TArray<uint8>& OutData) const
+{
+	OutData.Reset();
+	FMemoryWriter Writer(OutData);
+
+	uint32 SavedMagic = Magic;
+	uint32 SavedVersion = Version;
+	int32 EntriesNum = Entries.Num();
+	Writer << SavedMagic;
+	Writer << SavedVersion;
+	Writer << EntriesNum;
+
+	for (const FEntry& Entry : Entries)
+	{
+		FInteractionActorId ActorId = Entry.ActorId;
+		int32 Weight = Entry.Weight;
+		Writer << ActorId;
+		Writer << Weight;
+	}
+
+	int32 SavedActiveIndex = ActiveIndex;
+	float SavedElapsedTime = TimedElapsedTime;
+	float SavedDuration = TimedDuration;
+	Writer << SavedActiveIndex;
+	Writer << SavedElapsedTime;
+	Writer << SavedDuration;
+}
+
+bool FInteractionQueueSavedState::Read(const TArray<uint8>& Data)
+{
+	FMemoryReader Reader(Data);
+
+	uint32 SavedMagic = 0;
+	uint32 SavedVersion = 0;
+	int32 EntriesNum = 0;
+	Reader << SavedMagic;
+	Reader << SavedVersion;
+	Reader << EntriesNum;
+
+	if (Reader.IsError()
+		|| SavedMagic != Magic
+		|| SavedVersion == 0
+		|| SavedVersion > Version
+		|| EntriesNum < 0
+		|| EntriesNum > Data.Num())
+	{
+		return false;
+	}
+
+	Entries.Reset(EntriesNum);
+
+	for (int32 i = 0; i < EntriesNum && !Reader.IsError(); ++i)
+	{
+		FEntry& Entry = Entries.AddDefaulted_GetRef();
+
+		if (SavedVersion == 1)
+		{
+			FSoftObjectPath ActorPath;
+			Reader << ActorPath;
+			Entry.ActorId.Path = ConvertLegacyPath(ActorPath);
+		}
+		else
+		{
+			Reader << Entry.ActorId;
+		}
+
+		Reader << Entry.Weight;
+	}
+
+	Reader << ActiveIndex;
+	Reader << TimedElapsedTime;
+	Reader << TimedDuration;
+
+	return !Reader.IsError();
+}
+
+void FInteractionWorldSavedState::Write(TArray<uint8>& OutData) const
+{
+	OutData.Reset();
+	FMemoryWriter Writer(OutData);
+
+	uint32 SavedMagic = Magic;
+	uint32 SavedVersion = Version;
+	int32 EntriesNum = Entries.Num();
+	Writer << SavedMagic;
+	Writer << SavedVersion;
+	Writer << EntriesNum;
+
+	for (const FEntry& Entry : Entries)
+	{
+		FInteractionActorId OwnerId = Entry.OwnerId;
+		FName ComponentName = Entry.ComponentName;
+		TArray<uint8> ComponentData = Entry.Data;
+		Writer << OwnerId;
+		Writer << ComponentName;
+		Writer << ComponentData;
+	}
+}
+
+bool FInteractionWorldSavedState::Read(const TArray<uint8>& Data)
+{
+	FMemoryReader Reader(Data);
+
+	uint32 SavedMagic = 0;
+	uint32 SavedVersion = 0;
+	int32 EntriesNum = 0;
+	Reader << SavedMagic;
+	Reader << SavedVersion;
+	Reader << EntriesNum;
+
+	if (Reader.IsError()
+		|| SavedMagic != Magic
+		|| SavedVersion == 0
+		|| SavedVersion > Version
+		|| EntriesNum < 0
+		|| EntriesNum > Data.Num())
+	{
+		return false;
+	}
+
+	Entries.Reset(EntriesNum);
+
+	for (int32 i = 0; i < EntriesNum && !Reader.IsError(); ++i)
+	{
+		FEntry& Entry = Entries.AddDefaulted_GetRef();
+
+		if (SavedVersion == 1)
+		{
+			// The component path is split into the path of its owner and its name
+			FSoftObjectPath ComponentPath;
+			Reader << ComponentPath;
+			ComponentPath = ConvertLegacyPath(ComponentPath);
+
+			FString OwnerSubPath, ComponentName;
+
+			if (ComponentPath.GetSubPathString().Split(TEXT("."), &OwnerSubPath, &ComponentName, ESearchCase::CaseSensitive,
+			                                           ESearchDir::FromEnd))
+			{
+				Entry.OwnerId.Path = FSoftObjectPath(ComponentPath.GetAssetPath(), OwnerSubPath);
+				Entry.ComponentName = FName(*ComponentName);
+			}
+		}
+		else
+		{
+			Reader << Entry.OwnerId;
+			Reader << Entry.ComponentName;
+		}
+
+		Reader << Entry.Data;
+	}
+
+	return !Reader.IsError();
+}
@@ -0,0 +1,72 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractionTraceBudget.h"
+
+bool FInteractionTraceBudget::TryConsume(const FObjectKey Consumer, const int32 Budget, const uint64 Frame)
+{
+	if (Budget <= 0)
+	{
+		Reset();
+		return true;
+	}
+
+	if (Frame != CurrentFrame)
+	{
+		BeginFrame(Budget, Frame);
+	}
+
+	const uint64* RefusedFrame = StarvedConsumers.Find(Consumer);
+
+	if (RefusedFrame && *RefusedFrame != Frame && ReservedNum > 0)
+	{
+		StarvedConsumers.Remove(Consumer);
+		--ReservedNum;
+		++UsedNum;
+		return true;
+	}
+
+	// The reserved slots can't be taken by the consumers which weren't refused before
+	if (UsedNum + ReservedNum >= Budget)
+	{
+		StarvedConsumers.Add(Consumer, Frame);
+		return false;
+	}
+
+	if (RefusedFrame)
+	{
+		StarvedConsumers.Remove(Consumer);
+	}
+
+	++UsedNum;
+	return true;
+}
+
+void FInteractionTraceBudget::Remove(const FObjectKey Consumer)
+{
+	StarvedConsumers.Remove(Consumer);
+}
+
+void FInteractionTraceBudget::Reset()
+{
+	CurrentFrame = 0;
+	UsedNum = 0;
+	ReservedNum = 0;
+	StarvedConsumers.Reset();
+}
+
+void FInteractionTraceBudget::BeginFrame(const int32 Budget, const uint64 Frame)
+{
+	// A consumer which didn't come back in the frame after its refusal doesn't trace anymore, e.g. its tick was disabled
+	for (auto It = StarvedConsumers.CreateIterator(); It; ++It)
+	{
+		if (It.Value() + 1 < Frame)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	CurrentFrame = Frame;
+	UsedNum = 0;
+	ReservedNum = FMath::Min(StarvedConsumers.Num(), Budget);
+}
@@ -0,0 +1,89 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractionViewPredictor.h"
+
+void FInteractionViewPredictor::AddSample(const FVector& Location, const FQuat& Rotation, const double Time)
+{
+	const float ElapsedTime = static_cast<float>(Time - LastTime);
+
+	if (!bHasSample || ElapsedTime > MaxSampleInterval)
+	{
+		Reset();
+	}
+	else if (ElapsedTime > UE_KINDA_SMALL_NUMBER)
+	{
+		const FVector NewLinearVelocity = (Location - LastLocation) / ElapsedTime;
+
+		// The shortest rotation from the last sample
+		FQuat DeltaRotation = Rotation * LastRotation.Inverse();
+
+		if (DeltaRotation.W < 0.0)
+		{
+			DeltaRotation = FQuat(-DeltaRotation.X, -DeltaRotation.Y, -DeltaRotation.Z, -DeltaRotation.W);
+		}
+
+		const FVector NewAngularVelocity = DeltaRotation.GetRotationAxis() * (DeltaRotation.GetAngle() / ElapsedTime);
+
+		if (bHasVelocity)
+		{
+			LinearAcceleration = (NewLinearVelocity - LinearVelocity) / ElapsedTime;
+			AngularAcceleration = (NewAngularVelocity - AngularVelocity) / ElapsedTime;
+		}
+
+		LinearVelocity = NewLinearVelocity;
+		AngularVelocity = NewAngularVelocity;
+		bHasVelocity = true;
+	}
+
+	LastLocation = Location;
+	LastRotation = Rotation;
+	LastTime = Time;
+	bHasSample = true;
+}
+
+void FInteractionViewPredictor::Predict(const float LookAhead, FVector& OutLocation, FQuat& OutRotation) const
+{
+	OutLocation = LastLocation + GetTravel(LinearVelocity, LinearAcceleration, LookAhead);
+	OutRotation = LastRotation;
+
+	const FVector AngularDelta = GetTravel(AngularVelocity, AngularAcceleration, LookAhead);
+	const float Angle = FMath::Min(static_cast<float>(AngularDelta.Size()), MaxPredictedAngle);
+
+	if (Angle > UE_KINDA_SMALL_NUMBER)
+	{
+		OutRotation = FQuat(AngularDelta.GetUnsafeNormal(), Angle) * LastRotation;
+		OutRotation.Normalize();
+	}
+}
+
+void FInteractionViewPredictor::Reset()
+{
+	bHasSample = false;
+	bHasVelocity = false;
+	LinearVelocity = FVector::ZeroVector;
+	AngularVelocity = FVector::ZeroVector;
+	LinearAcceleration = FVector::ZeroVector;
+	AngularAcceleration = FVector::ZeroVector;
+}
+
+FVector FInteractionViewPredictor::GetTravel(const FVector& Velocity, const FVector& Acceleration, const float Time)
+{
+	const double Speed = Velocity.Size();
+
+	if (Speed <= UE_KINDA_SMALL_NUMBER)
+	{
+		return FVector::ZeroVector;
+	}
+
+	const FVector Direction = Velocity / Speed;
+	const double Deceleration = -FVector::DotProduct(Acceleration, Direction);
+
+	if (Deceleration <= 0.0)
+	{
+		return Velocity * Time;
+	}
+
+	const double StopTime = FMath::Min(static_cast<double>(Time), Speed / Deceleration);
+	return Direction * (Speed * StopTime - 0.5 * Deceleration * StopTime * StopTime);
+}
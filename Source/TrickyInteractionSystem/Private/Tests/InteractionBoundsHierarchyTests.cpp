@@ -0,0 +1,195 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractionBoundsHierarchy.h"
+#include "Components/BoxComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	constexpr double TestBoxExtent = 50.0;
+
+	/** Transient game world for the duration of a test */
+	struct FTestWorld
+	{
+		UWorld* World = nullptr;
+
+		FTestWorld()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("InteractionBoundsHierarchyTest"));
+			FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+		}
+
+		~FTestWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		AActor* SpawnBox(const FVector& Location) const
+		{
+			AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Location));
+			UBoxComponent* Box = NewObject<UBoxComponent>(Actor);
+			Box->SetBoxExtent(FVector(TestBoxExtent));
+			Actor->SetRootComponent(Box);
+			Box->RegisterComponent();
+			Box->SetWorldLocation(Location);
+			return Actor;
+		}
+	};
+
+	const FVector RayStart(-1000.0, 0.0, 0.0);
+
+	const FVector RayEnd(10000.0, 0.0, 0.0);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionBoundsHierarchyRaycastTest,
+                                 "TrickyInteraction.BoundsHierarchy.Raycast",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionBoundsHierarchyRaycastTest::RunTest(const FString& Parameters)
+{
+	const FTestWorld TestWorld;
+	FInteractionBoundsHierarchy Hierarchy;
+	FVector HitLocation = FVector::ZeroVector;
+
+	TestNull(TEXT("An empty hierarchy hits nothing"),
+	         Hierarchy.Raycast(RayStart, RayEnd, 0.f, {}, HitLocation));
+
+	AActor* Near = TestWorld.SpawnBox(FVector(0.0, 0.0, 0.0));
+	AActor* Far = TestWorld.SpawnBox(FVector(500.0, 0.0, 0.0));
+	AActor* Aside = TestWorld.SpawnBox(FVector(-500.0, 1000.0, 0.0));
+	Hierarchy.AddActor(Far);
+	Hierarchy.AddActor(Near);
+	Hierarchy.AddActor(Aside);
+	Hierarchy.AddActor(Near);
+
+	TestEqual(TEXT("Actors are added once"), Hierarchy.Num(), 3);
+	TestTrue(TEXT("The tree is valid after insertions"), Hierarchy.IsTreeValid());
+	TestEqual(TEXT("The closest actor is hit"),
+	          Hierarchy.Raycast(RayStart, RayEnd, 0.f, {}, HitLocation), Near);
+	TestTrue(TEXT("The hit location is on the bounds of the closest actor"),
+	         HitLocation.Equals(FVector(-TestBoxExtent, 0.0, 0.0), 1.0));
+
+	AActor* const Ignored[] = {Near};
+	TestEqual(TEXT("Ignored actors are skipped"),
+	          Hierarchy.Raycast(RayStart, RayEnd, 0.f, Ignored, HitLocation), Far);
+
+	TestEqual(TEXT("The radius widens the ray"),
+	          Hierarchy.Raycast(FVector(-1000.0, 900.0, 0.0), FVector(10000.0, 900.0, 0.0), 60.f, {}, HitLocation),
+	          Aside);
+
+	Hierarchy.RemoveActor(Near);
+	TestFalse(TEXT("Removed actors aren't contained"), Hierarchy.Contains(Near));
+	TestTrue(TEXT("The tree is valid after a removal"), Hierarchy.IsTreeValid());
+	TestEqual(TEXT("Removed actors aren't hit"),
+	          Hierarchy.Raycast(RayStart, RayEnd, 0.f, {}, HitLocation), Far);
+
+	Hierarchy.Reset();
+	TestEqual(TEXT("Reset removes every actor"), Hierarchy.Num(), 0);
+	TestTrue(TEXT("An empty tree is valid"), Hierarchy.IsTreeValid());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionBoundsHierarchyUpdateTest,
+                                 "TrickyInteraction.BoundsHierarchy.Update",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionBoundsHierarchyUpdateTest::RunTest(const FString& Parameters)
+{
+	const FTestWorld TestWorld;
+	FInteractionBoundsHierarchy Hierarchy;
+	FVector HitLocation = FVector::ZeroVector;
+
+	AActor* Moving = TestWorld.SpawnBox(FVector(0.0, 0.0, 0.0));
+	AActor* Static = TestWorld.SpawnBox(FVector(500.0, 0.0, 0.0));
+	Hierarchy.AddActor(Moving);
+	Hierarchy.AddActor(Static);
+
+	// A small move stays inside the enlarged leaf, a large one reinserts the leaf
+	Moving->SetActorLocation(FVector(0.0, 5.0, 0.0));
+	Hierarchy.Update();
+	TestTrue(TEXT("The tree is valid after a small move"), Hierarchy.IsTreeValid());
+	TestEqual(TEXT("The actor is hit after a small move"),
+	          Hierarchy.Raycast(RayStart, RayEnd, 0.f, {}, HitLocation), Moving);
+
+	Moving->SetActorLocation(FVector(0.0, 1000.0, 0.0));
+	Hierarchy.Update();
+	TestTrue(TEXT("The tree is valid after a large move"), Hierarchy.IsTreeValid());
+	TestEqual(TEXT("The moved actor isn't hit at its old location"),
+	          Hierarchy.Raycast(RayStart, RayEnd, 0.f, {}, HitLocation), Static);
+	TestEqual(TEXT("The moved actor is hit at its new location"),
+	          Hierarchy.Raycast(FVector(-1000.0, 1000.0, 0.0), FVector(10000.0, 1000.0, 0.0), 0.f, {}, HitLocation),
+	          Moving);
+
+	Static->Destroy();
+	Hierarchy.Update();
+	TestEqual(TEXT("Destroyed actors are dropped on update"), Hierarchy.Num(), 1);
+	TestTrue(TEXT("The tree is valid after dropping an actor"), Hierarchy.IsTreeValid());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionBoundsHierarchyRandomTest,
+                                 "TrickyInteraction.BoundsHierarchy.Random",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionBoundsHierarchyRandomTest::RunTest(const FString& Parameters)
+{
+	const FTestWorld TestWorld;
+	FInteractionBoundsHierarchy Hierarchy;
+	FRandomStream Random(1337);
+	constexpr int32 ActorsNum = 64;
+	TArray<AActor*> Actors;
+	TArray<bool> AddedActors;
+	AddedActors.Init(false, ActorsNum);
+
+	// Actors are placed in a row, so the expected hit is the added actor with the smallest X
+	for (int32 Index = 0; Index < ActorsNum; ++Index)
+	{
+		Actors.Add(TestWorld.SpawnBox(FVector(Index * 200.0, 0.0, 0.0)));
+	}
+
+	for (int32 Step = 0; Step < 512; ++Step)
+	{
+		const int32 Index = Random.RandRange(0, ActorsNum - 1);
+
+		if (AddedActors[Index])
+		{
+			Hierarchy.RemoveActor(Actors[Index]);
+		}
+		else
+		{
+			Hierarchy.AddActor(Actors[Index]);
+		}
+
+		AddedActors[Index] = !AddedActors[Index];
+
+		const int32 ExpectedIndex = AddedActors.Find(true);
+		AActor* Expected = ExpectedIndex == INDEX_NONE ? nullptr : Actors[ExpectedIndex];
+		FVector HitLocation = FVector::ZeroVector;
+
+		if (!TestTrue(TEXT("The tree is valid"), Hierarchy.IsTreeValid())
+			|| !TestEqual(TEXT("The closest added actor is hit"),
+			              Hierarchy.Raycast(RayStart, RayEnd, 0.f, {}, HitLocation),
+			              Expected))
+		{
+			break;
+		}
+	}
+
+	return true;
+}
+
+#endif
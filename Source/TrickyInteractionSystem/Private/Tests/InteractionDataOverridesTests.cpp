@@ -0,0 +1,42 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractionDefinition.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionDataOverridesMergedDataTest,
+                                 "TrickyInteraction.DataOverrides.MergedData",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionDataOverridesMergedDataTest::RunTest(const FString& Parameters)
+{
+	const UInteractionDefinition* Definition = NewObject<UInteractionDefinition>();
+	UInteractionDataOverrides* Overrides = NewObject<UInteractionDataOverrides>();
+	Overrides->bOverrideInteractionWeight = true;
+	Overrides->InteractionWeight = 5;
+
+	const FInteractionData& MergedData = Overrides->GetMergedData(Definition);
+	TestEqual(TEXT("The override is applied"), MergedData.InteractionWeight, 5);
+	TestTrue(TEXT("The other fields come from the definition"),
+	         MergedData.InteractionMessage.IdenticalTo(Definition->GetInteractionData().InteractionMessage));
+	TestTrue(TEXT("The merged data is stored by the overrides"), &Overrides->GetMergedData(Definition) == &MergedData);
+
+	Overrides->InteractionWeight = 7;
+	TestEqual(TEXT("A changed override is merged again"), Overrides->GetMergedData(Definition).InteractionWeight, 7);
+
+	Overrides->bOverrideInteractionWeight = false;
+	TestEqual(TEXT("A disabled override falls back to the definition"),
+	          Overrides->GetMergedData(Definition).InteractionWeight,
+	          Definition->GetInteractionData().InteractionWeight);
+
+	Overrides->bOverrideMaxInteractors = true;
+	Overrides->MaxInteractors = 2;
+	TestEqual(TEXT("A newly enabled override is merged"), Overrides->GetMergedData(Definition).MaxInteractors, 2);
+
+	return true;
+}
+
+#endif
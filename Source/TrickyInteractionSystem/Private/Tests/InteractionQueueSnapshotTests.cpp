@@ -0,0 +1,122 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractionQueueSnapshot.h"
+#include "Async/Async.h"
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionQueueSnapshotPublishTest,
+                                 "TrickyInteraction.QueueSnapshot.Publish",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionQueueSnapshotPublishTest::RunTest(const FString& Parameters)
+{
+	FInteractionQueueSnapshotBuffer Buffer;
+	FInteractionQueueSnapshot Snapshot;
+	Snapshot.FrameNumber = MAX_uint64;
+
+	TestTrue(TEXT("An empty buffer is read"), Buffer.Read(Snapshot));
+	TestEqual(TEXT("An empty buffer holds a default snapshot"), Snapshot.FrameNumber, static_cast<uint64>(0));
+	TestEqual(TEXT("An empty buffer holds an empty queue"), Snapshot.QueueNum, 0);
+
+	const FObjectKey HeadKey(AActor::StaticClass());
+	const FObjectKey SightKey(UObject::StaticClass());
+
+	// More publishes than slots, so the writer wraps around the buffer
+	for (uint64 Frame = 1; Frame <= 10; ++Frame)
+	{
+		FInteractionQueueSnapshot Published;
+		Published.Head = HeadKey;
+		Published.ActorInSight = SightKey;
+		Published.QueueKeys[0] = HeadKey;
+		Published.QueueKeysNum = 1;
+		Published.QueueNum = static_cast<int32>(Frame);
+		Published.FrameNumber = Frame;
+		Buffer.Publish(Published);
+
+		FInteractionQueueSnapshot Read;
+		TestTrue(TEXT("The snapshot is read"), Buffer.Read(Read));
+		TestEqual(TEXT("The latest snapshot is read"), Read.FrameNumber, Frame);
+		TestEqual(TEXT("The queue num is copied"), Read.QueueNum, static_cast<int32>(Frame));
+		TestTrue(TEXT("The head is copied"), Read.Head == HeadKey);
+		TestTrue(TEXT("The actor in sight is copied"), Read.ActorInSight == SightKey);
+		TestEqual(TEXT("The queue keys num is copied"), Read.QueueKeysNum, 1);
+		TestTrue(TEXT("The queue keys are copied"), Read.QueueKeys[0] == HeadKey);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionQueueSnapshotConcurrentTest,
+                                 "TrickyInteraction.QueueSnapshot.Concurrent",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionQueueSnapshotConcurrentTest::RunTest(const FString& Parameters)
+{
+	constexpr uint64 PublishesNum = 200000;
+
+	FInteractionQueueSnapshotBuffer Buffer;
+	std::atomic<bool> bIsPublishing = true;
+
+	// Every field is derived from the frame number, so a torn copy shows up as a mismatch
+	TFuture<TPair<int32, int32>> Reader = Async(EAsyncExecution::Thread, [&Buffer, &bIsPublishing]
+	{
+		int32 TornReads = 0;
+		int32 OutOfOrderReads = 0;
+		uint64 LastFrame = 0;
+
+		while (bIsPublishing.load(std::memory_order_acquire))
+		{
+			FInteractionQueueSnapshot Snapshot;
+
+			if (!Buffer.Read(Snapshot))
+			{
+				continue;
+			}
+
+			const int32 Expected = static_cast<int32>(Snapshot.FrameNumber % FInteractionQueueSnapshot::MaxQueueKeys);
+
+			if (Snapshot.QueueNum != Expected || Snapshot.QueueKeysNum != Expected)
+			{
+				++TornReads;
+			}
+
+			if (Snapshot.FrameNumber < LastFrame)
+			{
+				++OutOfOrderReads;
+			}
+
+			LastFrame = Snapshot.FrameNumber;
+		}
+
+		return TPair<int32, int32>(TornReads, OutOfOrderReads);
+	});
+
+	for (uint64 Frame = 1; Frame <= PublishesNum; ++Frame)
+	{
+		FInteractionQueueSnapshot Snapshot;
+		Snapshot.QueueNum = static_cast<int32>(Frame % FInteractionQueueSnapshot::MaxQueueKeys);
+		Snapshot.QueueKeysNum = Snapshot.QueueNum;
+		Snapshot.FrameNumber = Frame;
+		Buffer.Publish(Snapshot);
+	}
+
+	bIsPublishing.store(false, std::memory_order_release);
+	const TPair<int32, int32> Result = Reader.Get();
+
+	TestEqual(TEXT("No torn snapshot is read"), Result.Key, 0);
+	TestEqual(TEXT("Snapshots are read in publish order"), Result.Value, 0);
+
+	FInteractionQueueSnapshot Latest;
+	TestTrue(TEXT("The latest snapshot is read after publishing"), Buffer.Read(Latest));
+	TestEqual(TEXT("The last published snapshot is the latest"), Latest.FrameNumber, PublishesNum);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,250 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractableComponent.h"
+#include "InteractionQueueComponent.h"
+#include "InteractionRecording.h"
+#include "TrickyInteractionInterface.h"
+#include "TrickyInteractionSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace InteractionRecordingTests
+{
+	/** Transient game world for the duration of a test */
+	struct FTestWorld
+	{
+		UWorld* World = nullptr;
+
+		FTestWorld()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("InteractionRecordingTest"));
+			FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+		}
+
+		~FTestWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionRecordingVarintTest,
+                                 "TrickyInteraction.Recording.Varint",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionRecordingVarintTest::RunTest(const FString& Parameters)
+{
+	const TPair<uint64, int32> Cases[] = {
+		{0, 1},
+		{127, 1},
+		{128, 2},
+		{16383, 2},
+		{16384, 3},
+		{MAX_uint32, 5},
+		{MAX_uint64, 10}
+	};
+
+	TArray<uint8> Buffer;
+
+	for (const TPair<uint64, int32>& Case : Cases)
+	{
+		const int32 StartNum = Buffer.Num();
+		FInteractionRecordingFormat::WriteVarint(Buffer, Case.Key);
+		TestEqual(FString::Printf(TEXT("%llu is encoded into the expected number of bytes"), Case.Key),
+		          Buffer.Num() - StartNum,
+		          Case.Value);
+	}
+
+	int32 Offset = 0;
+
+	for (const TPair<uint64, int32>& Case : Cases)
+	{
+		uint64 Value = 0;
+		TestTrue(TEXT("The varint is read"), FInteractionRecordingFormat::ReadVarint(Buffer, Offset, Value));
+		TestEqual(TEXT("The varint round-trips"), Value, Case.Key);
+	}
+
+	TestEqual(TEXT("The whole buffer is read"), Offset, Buffer.Num());
+
+	// A continuation bit on the last byte means the data ended in the middle of a varint
+	const TArray<uint8> Truncated = {0x80, 0x80};
+	uint64 Value = 0;
+	Offset = 0;
+	TestFalse(TEXT("A truncated varint isn't read"), FInteractionRecordingFormat::ReadVarint(Truncated, Offset, Value));
+
+	TArray<uint8> Overlong;
+	Overlong.Init(0x80, 11);
+	Overlong.Add(0x01);
+	Offset = 0;
+	TestFalse(TEXT("A varint longer than 64 bits isn't read"),
+	          FInteractionRecordingFormat::ReadVarint(Overlong, Offset, Value));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionRecordingNameTest,
+                                 "TrickyInteraction.Recording.Name",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionRecordingNameTest::RunTest(const FString& Parameters)
+{
+	const FName Names[] = {
+		NAME_None,
+		FName(TEXT("BP_Door_C_12")),
+		FName(TEXT("InteractionQueue")),
+		FName(TEXT("Tür_Ключ"))
+	};
+
+	TArray<uint8> Buffer;
+
+	for (const FName Name : Names)
+	{
+		FInteractionRecordingFormat::WriteName(Buffer, Name);
+	}
+
+	int32 Offset = 0;
+
+	for (const FName Name : Names)
+	{
+		FName ReadName = NAME_None;
+		TestTrue(TEXT("The name is read"), FInteractionRecordingFormat::ReadName(Buffer, Offset, ReadName));
+		TestEqual(TEXT("The name round-trips"), ReadName, Name);
+	}
+
+	TestEqual(TEXT("The whole buffer is read"), Offset, Buffer.Num());
+
+	// The length prefix claims more bytes than the data holds
+	TArray<uint8> Truncated;
+	FInteractionRecordingFormat::WriteName(Truncated, FName(TEXT("Truncated")));
+	Truncated.Pop();
+	FName ReadName = NAME_None;
+	Offset = 0;
+	TestFalse(TEXT("A truncated name isn't read"), FInteractionRecordingFormat::ReadName(Truncated, Offset, ReadName));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionRecordingRecordTest,
+                                 "TrickyInteraction.Recording.Record",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionRecordingRecordTest::RunTest(const FString& Parameters)
+{
+	// Interned actor definition followed by an event which references it, as written by the first version
+	TArray<uint8> Buffer;
+	FInteractionRecordingFormat::WriteVarint(Buffer, 0);
+	Buffer.Add(static_cast<uint8>(EInteractionRecordType::DefineActor));
+	FInteractionRecordingFormat::WriteVarint(Buffer, 1);
+	FInteractionRecordingFormat::WriteName(Buffer, FName(TEXT("BP_Chest_C_0")));
+	FInteractionRecordingFormat::WriteVarint(Buffer, 300);
+	Buffer.Add(static_cast<uint8>(EInteractionRecordType::ActorAdded));
+	FInteractionRecordingFormat::WriteVarint(Buffer, 2);
+	FInteractionRecordingFormat::WriteVarint(Buffer, 1);
+
+	TestEqual(TEXT("Interned records stay compact"), Buffer.Num(), 21);
+
+	int32 Offset = 0;
+	uint64 FrameDelta = 0;
+	uint64 Id = 0;
+	FName Name = NAME_None;
+
+	TestTrue(TEXT("The frame delta of the definition is read"),
+	         FInteractionRecordingFormat::ReadVarint(Buffer, Offset, FrameDelta));
+	TestEqual(TEXT("The definition type is read"),
+	          Buffer[Offset++],
+	          static_cast<uint8>(EInteractionRecordType::DefineActor));
+	TestTrue(TEXT("The id is read"), FInteractionRecordingFormat::ReadVarint(Buffer, Offset, Id));
+	TestTrue(TEXT("The name is read"), FInteractionRecordingFormat::ReadName(Buffer, Offset, Name));
+	TestEqual(TEXT("The name of the definition round-trips"), Name, FName(TEXT("BP_Chest_C_0")));
+
+	TestTrue(TEXT("The frame delta of the event is read"),
+	         FInteractionRecordingFormat::ReadVarint(Buffer, Offset, FrameDelta));
+	TestEqual(TEXT("The frame delta round-trips"), FrameDelta, static_cast<uint64>(300));
+	TestEqual(TEXT("The event type is read"),
+	          Buffer[Offset++],
+	          static_cast<uint8>(EInteractionRecordType::ActorAdded));
+	TestTrue(TEXT("The component id is read"), FInteractionRecordingFormat::ReadVarint(Buffer, Offset, Id));
+	TestTrue(TEXT("The actor id is read"), FInteractionRecordingFormat::ReadVarint(Buffer, Offset, Id));
+	TestEqual(TEXT("The event references the interned actor"), Id, static_cast<uint64>(1));
+	TestEqual(TEXT("The whole record is read"), Offset, Buffer.Num());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionRecordingCallsTest,
+                                 "TrickyInteraction.Recording.Calls",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionRecordingCallsTest::RunTest(const FString& Parameters)
+{
+	using namespace InteractionRecordingTests;
+
+	const FTestWorld TestWorld;
+	UTrickyInteractionSubsystem* Subsystem = TestWorld.World->GetSubsystem<UTrickyInteractionSubsystem>();
+
+	if (!TestNotNull(TEXT("The subsystem exists"), Subsystem))
+	{
+		return false;
+	}
+
+	AActor* Interactor = TestWorld.World->SpawnActor<AActor>();
+	UInteractionQueueComponent* Component = NewObject<UInteractionQueueComponent>(Interactor);
+	Component->RegisterComponent();
+	Subsystem->RegisterQueueComponent(Component);
+
+	AActor* Door = TestWorld.World->SpawnActor<AActor>();
+	NewObject<UInteractableComponent>(Door)->RegisterComponent();
+	AActor* Wall = TestWorld.World->SpawnActor<AActor>();
+
+	const FString Filename = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("InteractionRecordingTest.bin"));
+	FInteractionRecorder Recorder;
+
+	if (!TestTrue(TEXT("The recording is started"), Recorder.Start(Subsystem, Filename)))
+	{
+		return false;
+	}
+
+	// Rejected calls don't broadcast anything, but they are recorded with their results
+	TestFalse(TEXT("A non-interactive actor isn't added"), Component->AddToInteractionQueue(Wall));
+	TestTrue(TEXT("The start on an empty queue is rejected"),
+	         Component->StartInteraction() == EInteractionResult::Invalid);
+	TestTrue(TEXT("The door is added"), Component->AddToInteractionQueue(Door));
+	TestTrue(TEXT("The door without handlers rejects the force"),
+	         Component->ForceInteraction() == EInteractionResult::Invalid);
+	Recorder.Stop();
+
+	// The interactor, its component, the wall and the door are defined once and referenced by four calls
+	TestEqual(TEXT("Every call is recorded"), Recorder.GetRecordsNum(), 8);
+
+	Component->RemoveFromInteractionQueue(Door);
+
+	FInteractionReplayer Replayer;
+
+	if (TestTrue(TEXT("The recording is loaded"), Replayer.Start(TestWorld.World, Filename)))
+	{
+		TestFalse(TEXT("The recording is replayed in one frame"), Replayer.Tick());
+		TestEqual(TEXT("Every record is applied"), Replayer.GetRecordsNum(), 8);
+		TestEqual(TEXT("The replayed results match the recorded ones"), Replayer.GetDivergencesNum(), 0);
+		TestEqual(TEXT("Every actor is resolved"), Replayer.GetUnresolvedNum(), 0);
+		TestTrue(TEXT("The door is added again"), Component->IsInInteractionQueue(Door));
+		Replayer.Stop();
+	}
+
+	IFileManager::Get().Delete(*Filename);
+	return true;
+}
+
+#endif
@@ -0,0 +1,263 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractableComponent.h"
+#include "InteractionQueueComponent.h"
+#include "InteractionSavedState.h"
+#include "TrickyInteractionSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/MemoryWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace InteractionSavedStateTests
+{
+	const TCHAR* ActorPath = TEXT("/Game/Maps/Test.Test:PersistentLevel.Door");
+
+	const TCHAR* PIEActorPath = TEXT("/Game/Maps/UEDPIE_0_Test.Test:PersistentLevel.Door");
+
+	const TCHAR* PIEComponentPath = TEXT("/Game/Maps/UEDPIE_0_Test.Test:PersistentLevel.Door.InteractionQueue");
+
+	/** Transient game world for the duration of a test */
+	struct FTestWorld
+	{
+		UWorld* World = nullptr;
+
+		FTestWorld()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("InteractionSavedStateTest"));
+			FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+		}
+
+		~FTestWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		AActor* SpawnInteractiveActor(const int32 MaxInteractors) const
+		{
+			AActor* Actor = World->SpawnActor<AActor>();
+			UInteractableComponent* Interactable = NewObject<UInteractableComponent>(Actor);
+			Interactable->InteractionData.MaxInteractors = MaxInteractors;
+			Interactable->RegisterComponent();
+			return Actor;
+		}
+
+		UInteractionQueueComponent* SpawnInteractor() const
+		{
+			AActor* Actor = World->SpawnActor<AActor>();
+			UInteractionQueueComponent* Component = NewObject<UInteractionQueueComponent>(Actor);
+
+			// The test actors don't overlap, so the saved queue is restored as is
+			const FBoolProperty* ReconcileProperty = CastField<FBoolProperty>(
+				UInteractionQueueComponent::StaticClass()->FindPropertyByName(TEXT("bReconcileOverlapsOnRestore")));
+			ReconcileProperty->SetPropertyValue_InContainer(Component, false);
+
+			Component->RegisterComponent();
+			return Component;
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionQueueSavedStateRoundTripTest,
+                                 "TrickyInteraction.SavedState.QueueRoundTrip",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionQueueSavedStateRoundTripTest::RunTest(const FString& Parameters)
+{
+	using namespace InteractionSavedStateTests;
+
+	FInteractionQueueSavedState SavedState;
+	FInteractionQueueSavedState::FEntry& SpawnedEntry = SavedState.Entries.AddDefaulted_GetRef();
+	SpawnedEntry.ActorId.Guid = FGuid(1, 2, 3, 4);
+	SpawnedEntry.Weight = -1;
+	FInteractionQueueSavedState::FEntry& LoadedEntry = SavedState.Entries.AddDefaulted_GetRef();
+	LoadedEntry.ActorId.Path = FSoftObjectPath(ActorPath);
+	LoadedEntry.Weight = 7;
+	SavedState.ActiveIndex = 1;
+	SavedState.TimedElapsedTime = 0.5f;
+	SavedState.TimedDuration = 2.f;
+
+	TArray<uint8> Data;
+	SavedState.Write(Data);
+
+	FInteractionQueueSavedState RestoredState;
+	TestTrue(TEXT("The state is read"), RestoredState.Read(Data));
+	TestEqual(TEXT("All entries are read"), RestoredState.Entries.Num(), 2);
+
+	if (RestoredState.Entries.Num() == 2)
+	{
+		TestTrue(TEXT("The persistent ID round-trips"), RestoredState.Entries[0].ActorId == SpawnedEntry.ActorId);
+		TestEqual(TEXT("The negative weight round-trips"), RestoredState.Entries[0].Weight, -1);
+		TestTrue(TEXT("The path round-trips"), RestoredState.Entries[1].ActorId == LoadedEntry.ActorId);
+		TestEqual(TEXT("The weight round-trips"), RestoredState.Entries[1].Weight, 7);
+	}
+
+	TestEqual(TEXT("The active index round-trips"), RestoredState.ActiveIndex, 1);
+	TestEqual(TEXT("The elapsed time round-trips"), RestoredState.TimedElapsedTime, 0.5f);
+	TestEqual(TEXT("The duration round-trips"), RestoredState.TimedDuration, 2.f);
+
+	TArray<uint8> Truncated = Data;
+	Truncated.SetNum(Data.Num() - 1);
+	TestFalse(TEXT("A truncated state isn't read"), FInteractionQueueSavedState().Read(Truncated));
+
+	TArray<uint8> Newer = Data;
+	Newer[sizeof(uint32)] = FInteractionQueueSavedState::Version + 1;
+	TestFalse(TEXT("A state of a newer version isn't read"), FInteractionQueueSavedState().Read(Newer));
+
+	TArray<uint8> WorldData;
+	FInteractionWorldSavedState().Write(WorldData);
+	TestFalse(TEXT("A state of another format isn't read"), FInteractionQueueSavedState().Read(WorldData));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionQueueSavedStateLegacyTest,
+                                 "TrickyInteraction.SavedState.QueueLegacy",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionQueueSavedStateLegacyTest::RunTest(const FString& Parameters)
+{
+	using namespace InteractionSavedStateTests;
+
+	// The first version stored the object paths of the actors, in PIE with the prefix of the instance
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	uint32 Magic = FInteractionQueueSavedState::Magic;
+	uint32 Version = 1;
+	int32 EntriesNum = 1;
+	FSoftObjectPath Path(PIEActorPath);
+	int32 Weight = 3;
+	int32 ActiveIndex = 0;
+	float TimedElapsedTime = 0.f;
+	float TimedDuration = 0.f;
+	Writer << Magic << Version << EntriesNum << Path << Weight << ActiveIndex << TimedElapsedTime << TimedDuration;
+
+	FInteractionQueueSavedState SavedState;
+	TestTrue(TEXT("The first version is read"), SavedState.Read(Data));
+	TestEqual(TEXT("The entry is read"), SavedState.Entries.Num(), 1);
+
+	if (SavedState.Entries.Num() == 1)
+	{
+		TestFalse(TEXT("The entry has no persistent ID"), SavedState.Entries[0].ActorId.Guid.IsValid());
+		TestTrue(TEXT("The PIE prefix is removed from the path"),
+		         SavedState.Entries[0].ActorId.Path == FSoftObjectPath(ActorPath));
+		TestEqual(TEXT("The weight is read"), SavedState.Entries[0].Weight, 3);
+	}
+
+	TestEqual(TEXT("The active index is read"), SavedState.ActiveIndex, 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionWorldSavedStateTest,
+                                 "TrickyInteraction.SavedState.World",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionWorldSavedStateTest::RunTest(const FString& Parameters)
+{
+	using namespace InteractionSavedStateTests;
+
+	FInteractionWorldSavedState SavedState;
+	FInteractionWorldSavedState::FEntry& Entry = SavedState.Entries.AddDefaulted_GetRef();
+	Entry.OwnerId.Guid = FGuid(5, 6, 7, 8);
+	Entry.ComponentName = TEXT("InteractionQueue");
+	Entry.Data = {1, 2, 3};
+
+	TArray<uint8> Data;
+	SavedState.Write(Data);
+
+	FInteractionWorldSavedState RestoredState;
+	TestTrue(TEXT("The state is read"), RestoredState.Read(Data));
+	TestEqual(TEXT("The entry is read"), RestoredState.Entries.Num(), 1);
+
+	if (RestoredState.Entries.Num() == 1)
+	{
+		TestTrue(TEXT("The owner ID round-trips"), RestoredState.Entries[0].OwnerId == Entry.OwnerId);
+		TestTrue(TEXT("The component name round-trips"), RestoredState.Entries[0].ComponentName == Entry.ComponentName);
+		TestTrue(TEXT("The component data round-trips"), RestoredState.Entries[0].Data == Entry.Data);
+	}
+
+	// The first version stored the object paths of the components
+	TArray<uint8> LegacyData;
+	FMemoryWriter Writer(LegacyData);
+	uint32 Magic = FInteractionWorldSavedState::Magic;
+	uint32 Version = 1;
+	int32 EntriesNum = 1;
+	FSoftObjectPath ComponentPath(PIEComponentPath);
+	TArray<uint8> ComponentData = {4, 5};
+	Writer << Magic << Version << EntriesNum << ComponentPath << ComponentData;
+
+	TestTrue(TEXT("The first version is read"), RestoredState.Read(LegacyData));
+	TestEqual(TEXT("The legacy entry is read"), RestoredState.Entries.Num(), 1);
+
+	if (RestoredState.Entries.Num() == 1)
+	{
+		TestTrue(TEXT("The component path is split into the owner path"),
+		         RestoredState.Entries[0].OwnerId.Path == FSoftObjectPath(ActorPath));
+		TestTrue(TEXT("The component path is split into the component name"),
+		         RestoredState.Entries[0].ComponentName == FName(TEXT("InteractionQueue")));
+		TestTrue(TEXT("The legacy component data is read"), RestoredState.Entries[0].Data == ComponentData);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionSavedStateReservationTest,
+                                 "TrickyInteraction.SavedState.Reservation",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionSavedStateReservationTest::RunTest(const FString& Parameters)
+{
+	using namespace InteractionSavedStateTests;
+
+	const FTestWorld TestWorld;
+	UTrickyInteractionSubsystem* Subsystem = TestWorld.World->GetSubsystem<UTrickyInteractionSubsystem>();
+
+	if (!TestNotNull(TEXT("The subsystem exists"), Subsystem))
+	{
+		return false;
+	}
+
+	AActor* Door = TestWorld.SpawnInteractiveActor(1);
+	Subsystem->SetPersistentActorId(Door, FGuid(1, 2, 3, 4));
+
+	// Two states saved while interacting with the same door, e.g. by two players at different times
+	FInteractionQueueSavedState SavedState;
+	FInteractionQueueSavedState::FEntry& Entry = SavedState.Entries.AddDefaulted_GetRef();
+	Entry.ActorId.Guid = Subsystem->GetPersistentActorId(Door);
+	SavedState.ActiveIndex = 0;
+	SavedState.TimedElapsedTime = 0.5f;
+	SavedState.TimedDuration = 2.f;
+
+	TArray<uint8> Data;
+	SavedState.Write(Data);
+
+	UInteractionQueueComponent* First = TestWorld.SpawnInteractor();
+	UInteractionQueueComponent* Second = TestWorld.SpawnInteractor();
+
+	TestTrue(TEXT("The first state is restored"), First->RestoreInteractionState(Data));
+	TestTrue(TEXT("The second state is restored"), Second->RestoreInteractionState(Data));
+
+	TestTrue(TEXT("The first interactor keeps the active interaction"), First->GetActiveInteractionActor() == Door);
+	TestTrue(TEXT("The first interactor resumes the timed interaction"), First->IsTimedInteractionActive());
+	TestEqual(TEXT("The door is reserved once"), Subsystem->GetInteractionReservationsNum(Door), 1);
+
+	TestNull(TEXT("The second interactor is restored without the active interaction"),
+	         Second->GetActiveInteractionActor());
+	TestFalse(TEXT("The second interactor doesn't resume the timed interaction"), Second->IsTimedInteractionActive());
+	TestTrue(TEXT("The second interactor still queues the door"), Second->IsInInteractionQueue(Door));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,158 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractionTimerWheel.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	using FTestTimerWheel = TInteractionTimerWheel<int32>;
+	using FExpiredTimers = TArray<TPair<uint32, int32>>;
+
+	/** Wheel with a short revolution, so the tests can schedule timers further than one revolution */
+	constexpr double TestSlotDuration = 0.1;
+
+	constexpr int32 TestSlotsNum = 8;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionTimerWheelScheduleTest,
+                                 "TrickyInteraction.TimerWheel.Schedule",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionTimerWheelScheduleTest::RunTest(const FString& Parameters)
+{
+	FTestTimerWheel Wheel(TestSlotDuration, TestSlotsNum);
+	FExpiredTimers Expired;
+
+	const uint32 FirstHandle = Wheel.Schedule(1.0, 1);
+	const uint32 SecondHandle = Wheel.Schedule(1.05, 2);
+
+	TestNotEqual(TEXT("Handles are never 0"), FirstHandle, 0u);
+	TestNotEqual(TEXT("Handles are unique"), FirstHandle, SecondHandle);
+	TestEqual(TEXT("Scheduled timers are counted"), Wheel.Num(), 2);
+	TestTrue(TEXT("The timer is scheduled"), Wheel.IsScheduled(FirstHandle));
+
+	Wheel.Advance(0.5, Expired);
+	TestEqual(TEXT("Timers don't expire early"), Expired.Num(), 0);
+
+	Wheel.Advance(1.0, Expired);
+	TestEqual(TEXT("Only the due timer of the slot expires"), Expired.Num(), 1);
+
+	if (Expired.Num() == 1)
+	{
+		TestEqual(TEXT("The expired handle is returned"), Expired[0].Key, FirstHandle);
+		TestEqual(TEXT("The payload is returned"), Expired[0].Value, 1);
+	}
+
+	TestFalse(TEXT("Expired timers aren't scheduled"), Wheel.IsScheduled(FirstHandle));
+
+	Expired.Reset();
+	Wheel.Advance(1.06, Expired);
+	TestEqual(TEXT("The timer left in the current slot expires on the next advance"), Expired.Num(), 1);
+	TestEqual(TEXT("The wheel is empty"), Wheel.Num(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionTimerWheelCancelTest,
+                                 "TrickyInteraction.TimerWheel.Cancel",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionTimerWheelCancelTest::RunTest(const FString& Parameters)
+{
+	FTestTimerWheel Wheel(TestSlotDuration, TestSlotsNum);
+	FExpiredTimers Expired;
+
+	const uint32 CancelledHandle = Wheel.Schedule(0.5, 1);
+	const uint32 KeptHandle = Wheel.Schedule(0.5, 2);
+
+	TestTrue(TEXT("A scheduled timer is cancelled"), Wheel.Cancel(CancelledHandle));
+	TestFalse(TEXT("A timer is cancelled only once"), Wheel.Cancel(CancelledHandle));
+	TestFalse(TEXT("Unknown handles aren't cancelled"), Wheel.Cancel(0));
+	TestFalse(TEXT("The cancelled timer isn't scheduled"), Wheel.IsScheduled(CancelledHandle));
+	TestEqual(TEXT("Only the kept timer is counted"), Wheel.Num(), 1);
+
+	Wheel.Advance(1.0, Expired);
+	TestEqual(TEXT("Only the kept timer expires"), Expired.Num(), 1);
+
+	if (Expired.Num() == 1)
+	{
+		TestEqual(TEXT("The kept timer expires"), Expired[0].Key, KeptHandle);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionTimerWheelRevolutionTest,
+                                 "TrickyInteraction.TimerWheel.Revolution",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionTimerWheelRevolutionTest::RunTest(const FString& Parameters)
+{
+	FTestTimerWheel Wheel(TestSlotDuration, TestSlotsNum);
+	FExpiredTimers Expired;
+
+	// Two revolutions ahead, the slot of the timer is visited before the timer is due
+	Wheel.Schedule(2.05, 1);
+
+	for (double Time = 0.05; Time < 2.0; Time += TestSlotDuration)
+	{
+		Wheel.Advance(Time, Expired);
+	}
+
+	TestEqual(TEXT("Timers further than one revolution stay in their slot"), Expired.Num(), 0);
+
+	Wheel.Advance(2.15, Expired);
+	TestEqual(TEXT("The timer expires when it's due"), Expired.Num(), 1);
+
+	// A long frame visits every slot once
+	Expired.Reset();
+	Wheel.Schedule(2.25, 1);
+	Wheel.Schedule(2.55, 2);
+	Wheel.Advance(10.0, Expired);
+	TestEqual(TEXT("A long frame collects the timers of every slot"), Expired.Num(), 2);
+
+	// Timers scheduled in the past expire on the next advance
+	Expired.Reset();
+	Wheel.Schedule(5.0, 3);
+	Wheel.Advance(10.0, Expired);
+	TestEqual(TEXT("A timer scheduled in the past expires on the next advance"), Expired.Num(), 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionTimerWheelIdleTest,
+                                 "TrickyInteraction.TimerWheel.Idle",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionTimerWheelIdleTest::RunTest(const FString& Parameters)
+{
+	FTestTimerWheel Wheel(TestSlotDuration, TestSlotsNum);
+	FExpiredTimers Expired;
+
+	// The first advance after an idle period must not sweep every slot
+	Wheel.Advance(100.05, Expired);
+	TestEqual(TEXT("An empty wheel jumps to the current slot"), Wheel.GetCurrentSlotTick(), static_cast<int64>(1000));
+
+	Wheel.Schedule(100.25, 1);
+	Wheel.Advance(100.15, Expired);
+	TestEqual(TEXT("The timer doesn't expire early after the idle period"), Expired.Num(), 0);
+
+	Wheel.Advance(100.35, Expired);
+	TestEqual(TEXT("The timer expires after the idle period"), Expired.Num(), 1);
+
+	// Going back in time never moves the wheel backwards
+	const int64 SlotTick = Wheel.GetCurrentSlotTick();
+	Wheel.Advance(50.05, Expired);
+	TestEqual(TEXT("The wheel doesn't move backwards"), Wheel.GetCurrentSlotTick(), SlotTick);
+
+	return true;
+}
+
+#endif
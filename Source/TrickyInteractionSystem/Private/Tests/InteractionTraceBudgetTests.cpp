@@ -0,0 +1,73 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractionTraceBudget.h"
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionTraceBudgetFairnessTest,
+                                 "TrickyInteraction.TraceBudget.Fairness",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionTraceBudgetFairnessTest::RunTest(const FString& Parameters)
+{
+	const FObjectKey First(UObject::StaticClass());
+	const FObjectKey Second(AActor::StaticClass());
+
+	FInteractionTraceBudget Budget;
+
+	// The first consumer comes first in every frame, with one trace per frame they take turns
+	for (uint64 Frame = 1; Frame <= 6; ++Frame)
+	{
+		const bool bFirstTraced = Budget.TryConsume(First, 1, Frame);
+		const bool bSecondTraced = Budget.TryConsume(Second, 1, Frame);
+
+		TestTrue(FString::Printf(TEXT("One consumer traces in frame %llu"), Frame), bFirstTraced != bSecondTraced);
+		TestTrue(FString::Printf(TEXT("The second consumer traces in every other frame %llu"), Frame),
+		         bSecondTraced == (Frame % 2 == 0));
+	}
+
+	TestTrue(TEXT("An unlimited budget doesn't refuse"), Budget.TryConsume(First, 0, 7));
+	TestEqual(TEXT("An unlimited budget forgets the refusals"), Budget.GetStarvedNum(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionTraceBudgetExpirationTest,
+                                 "TrickyInteraction.TraceBudget.Expiration",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionTraceBudgetExpirationTest::RunTest(const FString& Parameters)
+{
+	const FObjectKey First(UObject::StaticClass());
+	const FObjectKey Second(AActor::StaticClass());
+	const FObjectKey Starved(UClass::StaticClass());
+	constexpr int32 TracesNum = 2;
+
+	FInteractionTraceBudget Budget;
+	TestTrue(TEXT("The first consumer traces"), Budget.TryConsume(First, TracesNum, 1));
+	TestTrue(TEXT("The second consumer traces"), Budget.TryConsume(Second, TracesNum, 1));
+	TestFalse(TEXT("The third consumer is refused"), Budget.TryConsume(Starved, TracesNum, 1));
+	TestEqual(TEXT("The refused consumer is starved"), Budget.GetStarvedNum(), 1);
+
+	// The starved consumer stops ticking, its slot stays reserved for one frame only
+	TestTrue(TEXT("The first consumer traces next to the reservation"), Budget.TryConsume(First, TracesNum, 2));
+	TestEqual(TEXT("A slot is reserved in the frame after the refusal"), Budget.GetReservedNum(), 1);
+
+	TestTrue(TEXT("The first consumer traces after the reservation expired"), Budget.TryConsume(First, TracesNum, 3));
+	TestEqual(TEXT("The unclaimed reservation expires"), Budget.GetReservedNum(), 0);
+	TestEqual(TEXT("The consumer which stopped ticking isn't starved anymore"), Budget.GetStarvedNum(), 0);
+	TestTrue(TEXT("The full budget is available again"), Budget.TryConsume(Second, TracesNum, 3));
+	TestFalse(TEXT("The budget is still limited"), Budget.TryConsume(Starved, TracesNum, 3));
+
+	Budget.Remove(Starved);
+	TestEqual(TEXT("A removed consumer isn't starved"), Budget.GetStarvedNum(), 0);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,95 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractionViewPredictor.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionViewPredictorLinearTest,
+                                 "TrickyInteraction.ViewPredictor.Linear",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionViewPredictorLinearTest::RunTest(const FString& Parameters)
+{
+	FInteractionViewPredictor Predictor;
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+
+	Predictor.AddSample(FVector(10.0, 0.0, 0.0), FQuat::Identity, 1.0);
+	Predictor.Predict(0.1f, Location, Rotation);
+	TestTrue(TEXT("A single sample isn't extrapolated"), Location.Equals(FVector(10.0, 0.0, 0.0)));
+
+	// 100 units per second along X
+	Predictor.AddSample(FVector(20.0, 0.0, 0.0), FQuat::Identity, 1.1);
+	Predictor.AddSample(FVector(30.0, 0.0, 0.0), FQuat::Identity, 1.2);
+	TestTrue(TEXT("The linear velocity is measured"), Predictor.GetLinearVelocity().Equals(FVector(100.0, 0.0, 0.0), 0.01));
+
+	Predictor.Predict(0.1f, Location, Rotation);
+	TestTrue(TEXT("A constant velocity is extrapolated"), Location.Equals(FVector(40.0, 0.0, 0.0), 0.01));
+	TestTrue(TEXT("The rotation isn't changed without angular velocity"), Rotation.Equals(FQuat::Identity));
+
+	// The velocity halves, the view decelerates with 500 units per second squared and stops after 0.1 seconds
+	Predictor.AddSample(FVector(35.0, 0.0, 0.0), FQuat::Identity, 1.3);
+	Predictor.Predict(1.f, Location, Rotation);
+	TestTrue(TEXT("The deceleration stops the prediction"), Location.Equals(FVector(37.5, 0.0, 0.0), 0.01));
+
+	// Speeding up isn't extrapolated, the prediction would overshoot where the motion ends
+	Predictor.AddSample(FVector(45.0, 0.0, 0.0), FQuat::Identity, 1.4);
+	Predictor.Predict(0.1f, Location, Rotation);
+	TestTrue(TEXT("The acceleration isn't extrapolated"), Location.Equals(FVector(55.0, 0.0, 0.0), 0.01));
+
+	// A long gap is a new motion
+	Predictor.AddSample(FVector(100.0, 0.0, 0.0), FQuat::Identity, 1.4 + FInteractionViewPredictor::MaxSampleInterval + 0.1);
+	TestTrue(TEXT("A long gap resets the velocity"), Predictor.GetLinearVelocity().IsZero());
+	Predictor.Predict(0.1f, Location, Rotation);
+	TestTrue(TEXT("The sample after a gap isn't extrapolated"), Location.Equals(FVector(100.0, 0.0, 0.0)));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionViewPredictorAngularTest,
+                                 "TrickyInteraction.ViewPredictor.Angular",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::EngineFilter)
+
+bool FInteractionViewPredictorAngularTest::RunTest(const FString& Parameters)
+{
+	FInteractionViewPredictor Predictor;
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+
+	// 10 degrees of yaw per 0.1 seconds
+	const float Step = FMath::DegreesToRadians(10.f);
+
+	for (int32 i = 0; i < 3; ++i)
+	{
+		Predictor.AddSample(FVector::ZeroVector, FQuat(FVector::UpVector, Step * i), 0.1 * i);
+	}
+
+	TestTrue(TEXT("The angular velocity is measured around the rotation axis"),
+	         Predictor.GetAngularVelocity().Equals(FVector::UpVector * Step * 10.f, 0.001));
+
+	Predictor.Predict(0.1f, Location, Rotation);
+	TestTrue(TEXT("A constant angular velocity is extrapolated"),
+	         Rotation.Equals(FQuat(FVector::UpVector, Step * 3.f), 0.001));
+	TestTrue(TEXT("The location isn't changed without linear velocity"), Location.IsZero());
+
+	Predictor.Predict(10.f, Location, Rotation);
+	TestTrue(TEXT("The predicted rotation is limited"),
+	         Rotation.Equals(FQuat(FVector::UpVector, Step * 2.f + FInteractionViewPredictor::MaxPredictedAngle), 0.001));
+
+	// The shortest rotation is measured across the flip of the quaternion sign
+	Predictor.Reset();
+	const FQuat Start(FVector::UpVector, FMath::DegreesToRadians(175.f));
+	const FQuat End(FVector::UpVector, FMath::DegreesToRadians(-175.f));
+	Predictor.AddSample(FVector::ZeroVector, Start, 0.0);
+	Predictor.AddSample(FVector::ZeroVector, End, 0.1);
+	TestTrue(TEXT("The angular velocity takes the shortest rotation"),
+	         Predictor.GetAngularVelocity().Equals(FVector::UpVector * FMath::DegreesToRadians(100.f), 0.001));
+
+	return true;
+}
+
+#endif
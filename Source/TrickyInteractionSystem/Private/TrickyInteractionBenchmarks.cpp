@@ -0,0 +1,283 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyInteractionBenchmarks.h"
+
+#include "InteractionQueueComponent.h"
+#include "InteractionViewPredictor.h"
+#include "TrickyInteractionInterface.h"
+#include "TrickyInteractionLibrary.h"
+#include "HAL/IConsoleManager.h"
+
+void UInteractionBenchmarkListener::HandleInteractionStarted(UInteractionQueueComponent* Component,
+                                                             AActor* InteractiveActor,
+                                                             EInteractionResult InteractionResult)
+{
+	++CallsNum;
+}
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	template <typename FunctionType>
+	double MeasureNanosecondsPerCall(const int32 Iterations, FunctionType&& Function)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			Function();
+		}
+
+		return (FPlatformTime::Seconds() - StartTime) * 1.0e9 / FMath::Max(Iterations, 1);
+	}
+
+	void BenchmarkBroadcast(const TArray<FString>& Args)
+	{
+		const int32 Iterations = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100000;
+		const int32 ListenersNums[] = {0, 1, 10};
+		int32 NativeCallsNum = 0;
+
+		UE_LOG(LogTrickyInteractionSystem, Display, TEXT("Broadcast benchmark, %d iterations"), Iterations);
+
+		for (const int32 ListenersNum : ListenersNums)
+		{
+			FOnInteractionStartedSignature NativeDelegate;
+			FOnInteractionStartedDynamicSignature DynamicDelegate;
+			TArray<UInteractionBenchmarkListener*> Listeners;
+
+			for (int32 i = 0; i < ListenersNum; ++i)
+			{
+				UInteractionBenchmarkListener* Listener = NewObject<UInteractionBenchmarkListener>();
+				Listener->AddToRoot();
+				Listeners.Add(Listener);
+
+				NativeDelegate.AddLambda([&NativeCallsNum](UInteractionQueueComponent*, AActor*, EInteractionResult)
+				{
+					++NativeCallsNum;
+				});
+
+				FScriptDelegate ScriptDelegate;
+				ScriptDelegate.BindUFunction(Listener,
+				                             GET_FUNCTION_NAME_CHECKED(UInteractionBenchmarkListener,
+				                                                       HandleInteractionStarted));
+				DynamicDelegate.Add(ScriptDelegate);
+			}
+
+			const double NativeTime = MeasureNanosecondsPerCall(Iterations, [&NativeDelegate]()
+			{
+				NativeDelegate.Broadcast(nullptr, nullptr, EInteractionResult::Success);
+			});
+
+			const double DynamicTime = MeasureNanosecondsPerCall(Iterations, [&DynamicDelegate]()
+			{
+				DynamicDelegate.Broadcast(nullptr, nullptr, EInteractionResult::Success);
+			});
+
+			const double GuardedDynamicTime = MeasureNanosecondsPerCall(Iterations, [&DynamicDelegate]()
+			{
+				if (DynamicDelegate.IsBound())
+				{
+					DynamicDelegate.Broadcast(nullptr, nullptr, EInteractionResult::Success);
+				}
+			});
+
+			UE_LOG(LogTrickyInteractionSystem, Display,
+			       TEXT("  %2d listeners: native %.1f ns, dynamic %.1f ns, guarded dynamic %.1f ns"),
+			       ListenersNum, NativeTime, DynamicTime, GuardedDynamicTime);
+
+			for (UInteractionBenchmarkListener* Listener : Listeners)
+			{
+				Listener->RemoveFromRoot();
+			}
+		}
+	}
+
+	/**
+	 * Targets are placed around the viewer with equal spacing, a target is in sight if the view points into its cone
+	 */
+	constexpr int32 PredictionTargetsNum = 12;
+
+	constexpr float PredictionTargetSpacing = 360.f / PredictionTargetsNum;
+
+	constexpr float PredictionTargetHalfAngle = 4.f;
+
+	int32 GetPredictionTargetAtYaw(const float Yaw)
+	{
+		const int32 Index = FMath::RoundToInt(Yaw / PredictionTargetSpacing);
+		const float Distance = FMath::Abs(FMath::FindDeltaAngleDegrees(Yaw, Index * PredictionTargetSpacing));
+
+		if (Distance > PredictionTargetHalfAngle)
+		{
+			return INDEX_NONE;
+		}
+
+		return (Index % PredictionTargetsNum + PredictionTargetsNum) % PredictionTargetsNum;
+	}
+
+	/**
+	 * Generates the yaw of a camera which flicks between random targets and dwells on them
+	 */
+	void GenerateFlickingCameraYaws(const int32 Seed, const int32 StepsNum, const float Step, TArray<float>& OutYaws)
+	{
+		FRandomStream Random(Seed);
+		float Yaw = 0.f;
+		float StartYaw = 0.f;
+		float TargetYaw = 0.f;
+		float MoveTime = 0.f;
+		float MoveDuration = 0.f;
+		float DwellTime = 0.f;
+
+		OutYaws.Reset(StepsNum);
+
+		for (int32 i = 0; i < StepsNum; ++i)
+		{
+			if (MoveTime < MoveDuration)
+			{
+				MoveTime += Step;
+				Yaw = FMath::Lerp(StartYaw, TargetYaw, FMath::SmoothStep(0.f, 1.f, MoveTime / MoveDuration));
+			}
+			else if (DwellTime > 0.f)
+			{
+				DwellTime -= Step;
+			}
+			else
+			{
+				const float NextTargetYaw = Random.RandRange(0, PredictionTargetsNum - 1) * PredictionTargetSpacing;
+				const float DeltaYaw = FMath::FindDeltaAngleDegrees(Yaw, NextTargetYaw);
+				const float AverageSpeed = Random.FRandRange(180.f, 900.f);
+
+				StartYaw = Yaw;
+				TargetYaw = Yaw + DeltaYaw;
+				MoveTime = 0.f;
+				MoveDuration = FMath::Max(FMath::Abs(DeltaYaw) / AverageSpeed, Step);
+				DwellTime = Random.FRandRange(0.2f, 0.8f);
+			}
+
+			OutYaws.Add(Yaw);
+		}
+	}
+
+	struct FPredictionBenchmarkResult
+	{
+		/** Share of the time in which the held line of sight result matched the target the camera pointed at */
+		float HitRate = 0.f;
+
+		/** Share of the time without a target in which the held result still reported one */
+		float FalsePositiveRate = 0.f;
+	};
+
+	/**
+	 * Simulates the line of sight checks of a camera following the yaws
+	 * The game runs at 60 frames per second, the check is made once per tick interval and its result is held until
+	 * the next one. With the prediction the view is sampled every frame like UInteractionQueueComponent does.
+	 */
+	FPredictionBenchmarkResult SimulateLineOfSight(const TArray<float>& Yaws,
+	                                               const float Step,
+	                                               const float TickInterval,
+	                                               const bool bPredict,
+	                                               const float PredictionFactor)
+	{
+		constexpr float FrameTime = 1.f / 60.f;
+		const int32 StepsPerFrame = FMath::Max(FMath::RoundToInt(FrameTime / Step), 1);
+		FInteractionViewPredictor Predictor;
+		int32 HeldTarget = INDEX_NONE;
+		float TimeSinceCheck = TickInterval;
+		int32 FramesWithTarget = 0;
+		int32 FramesWithoutTarget = 0;
+		int32 HitsNum = 0;
+		int32 FalsePositivesNum = 0;
+
+		for (int32 i = 0; i < Yaws.Num(); ++i)
+		{
+			if (i % StepsPerFrame == 0)
+			{
+				const FQuat ViewRotation = FRotator(0.f, Yaws[i], 0.f).Quaternion();
+				TimeSinceCheck += i > 0 ? FrameTime : 0.f;
+
+				if (bPredict)
+				{
+					Predictor.AddSample(FVector::ZeroVector, ViewRotation, i * Step);
+				}
+
+				if (TimeSinceCheck >= TickInterval)
+				{
+					float TraceYaw = Yaws[i];
+					TimeSinceCheck = 0.f;
+
+					if (bPredict)
+					{
+						FVector PredictedLocation = FVector::ZeroVector;
+						FQuat PredictedRotation = FQuat::Identity;
+						Predictor.Predict(TickInterval * PredictionFactor, PredictedLocation, PredictedRotation);
+						TraceYaw = PredictedRotation.Rotator().Yaw;
+					}
+
+					HeldTarget = GetPredictionTargetAtYaw(TraceYaw);
+				}
+			}
+
+			const int32 Target = GetPredictionTargetAtYaw(Yaws[i]);
+
+			if (Target != INDEX_NONE)
+			{
+				++FramesWithTarget;
+				HitsNum += HeldTarget == Target ? 1 : 0;
+			}
+			else
+			{
+				++FramesWithoutTarget;
+				FalsePositivesNum += HeldTarget != INDEX_NONE ? 1 : 0;
+			}
+		}
+
+		FPredictionBenchmarkResult Result;
+		Result.HitRate = static_cast<float>(HitsNum) / FMath::Max(FramesWithTarget, 1);
+		Result.FalsePositiveRate = static_cast<float>(FalsePositivesNum) / FMath::Max(FramesWithoutTarget, 1);
+		return Result;
+	}
+
+	void BenchmarkLineOfSightPrediction(const TArray<FString>& Args)
+	{
+		const float Duration = Args.IsValidIndex(0) ? FMath::Max(FCString::Atof(*Args[0]), 1.f) : 120.f;
+		const int32 Seed = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 1337;
+		const float PredictionFactor = Args.IsValidIndex(2) ? FMath::Clamp(FCString::Atof(*Args[2]), 0.f, 1.f) : 0.5f;
+		const float TickIntervals[] = {0.033f, 0.05f, 0.1f, 0.15f, 0.2f, 0.3f, 0.4f};
+		constexpr float Step = 1.f / 240.f;
+
+		TArray<float> Yaws;
+		GenerateFlickingCameraYaws(Seed, FMath::CeilToInt(Duration / Step), Step, Yaws);
+
+		UE_LOG(LogTrickyInteractionSystem, Display,
+		       TEXT("Line of sight prediction benchmark, %.0f s of flicks, seed %d, prediction factor %.2f"),
+		       Duration, Seed, PredictionFactor);
+		UE_LOG(LogTrickyInteractionSystem, Display,
+		       TEXT("  Requests missed by the held result are re-validated with one trace of the current view, so 100%% - hit rate of them need the extra trace"));
+
+		for (const float TickInterval : TickIntervals)
+		{
+			const FPredictionBenchmarkResult Current = SimulateLineOfSight(Yaws, Step, TickInterval, false, 0.f);
+			const FPredictionBenchmarkResult Predicted = SimulateLineOfSight(Yaws, Step, TickInterval, true,
+			                                                                 PredictionFactor);
+
+			UE_LOG(LogTrickyInteractionSystem, Display,
+			       TEXT("  Interval %.3f s: hit rate current %5.1f%% predicted %5.1f%%, false positives current %4.1f%% predicted %4.1f%%"),
+			       TickInterval,
+			       Current.HitRate * 100.f,
+			       Predicted.HitRate * 100.f,
+			       Current.FalsePositiveRate * 100.f,
+			       Predicted.FalsePositiveRate * 100.f);
+		}
+	}
+}
+
+static FAutoConsoleCommand InteractionBenchmarkBroadcastCommand(
+	TEXT("TrickyInteraction.Benchmark.Broadcast"),
+	TEXT("Measures the cost of native and dynamic interaction delegate broadcasts with 0, 1 and 10 listeners. Args: [Iterations]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkBroadcast));
+
+static FAutoConsoleCommand InteractionBenchmarkPredictionCommand(
+	TEXT("TrickyInteraction.Benchmark.LineOfSightPrediction"),
+	TEXT("Simulates a flicking camera and compares the line of sight hit rate of the current and the predicted view for several tick intervals. Args: [Seconds] [Seed] [PredictionFactor]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkLineOfSightPrediction));
+#endif
@@ -0,0 +1,27 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "TrickyInteractionBenchmarks.generated.h"
+
+enum class EInteractionResult : uint8;
+class UInteractionQueueComponent;
+
+/**
+ * Listener used by the benchmark console commands to bind dynamic delegates
+ */
+UCLASS(Transient)
+class UInteractionBenchmarkListener : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION()
+	void HandleInteractionStarted(UInteractionQueueComponent* Component,
+	                              AActor* InteractiveActor,
+	                              EInteractionResult InteractionResult);
+
+	int32 CallsNum = 0;
+};
@@ -3,29 +3,106 @@
 
 #include "TrickyInteractionLibrary.h"
 
+#include "InteractableComponent.h"
+#include "InteractionDefinition.h"
 #include "InteractionQueueComponent.h"
 #include "TrickyInteractionInterface.h"
+#include "TrickyInteractionScalability.h"
+#include "TrickyInteractionSubsystem.h"
+#include "Engine/World.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/UObjectGlobals.h"
 #include "GameFramework/Actor.h"
 
 DEFINE_LOG_CATEGORY(LogTrickyInteractionSystem);
 
+namespace
+{
+	TMap<FObjectKey, FInteractionDataProperties> InteractionDataPropertiesCache;
+
+	void PruneInteractionDataPropertiesCache()
+	{
+		for (auto It = InteractionDataPropertiesCache.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().ResolveObjectPtr())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	/**
+	 * Cached properties are owned by their class, so the cache is cleared when classes are reinstanced
+	 * (e.g. a Blueprint recompile or a hot reload) and pruned of unloaded classes after garbage collection
+	 */
+	void BindInteractionDataPropertiesCacheInvalidation()
+	{
+		static bool bIsBound = false;
+
+		if (bIsBound)
+		{
+			return;
+		}
+
+		bIsBound = true;
+		FCoreUObjectDelegates::GetPostGarbageCollect().AddStatic(&PruneInteractionDataPropertiesCache);
+
+#if WITH_EDITOR
+		FCoreUObjectDelegates::OnObjectsReplaced.AddStatic([](const TMap<UObject*, UObject*>&)
+		{
+			InteractionDataPropertiesCache.Reset();
+		});
+#endif
+	}
+}
+
 bool UTrickyInteractionLibrary::IsActorInteractive(AActor* Actor)
 {
-	if (!IsValid(Actor) || !Actor->Implements<UTrickyInteractionInterface>())
+	if (!IsValid(Actor))
+	{
+		return false;
+	}
+
+	if (FindInteractableComponent(Actor))
+	{
+		return true;
+	}
+
+	if (!Actor->Implements<UTrickyInteractionInterface>())
 	{
 		return false;
 	}
 
-	FInteractionData InteractionData;
-	return GetActorInteractionData(Actor, InteractionData);
+	return FindActorInteractionData(Actor) != nullptr;
 }
 
 bool UTrickyInteractionLibrary::GetActorInteractionData(AActor* Actor, FInteractionData& InteractionData)
 {
-	if (!IsValid(Actor) && !Actor->Implements<UTrickyInteractionInterface>())
+	const FInteractionData* FoundData = FindActorInteractionData(Actor);
+
+	if (!FoundData)
+	{
+		return false;
+	}
+
+	InteractionData = *FoundData;
+	return true;
+}
+
+const FInteractionData* UTrickyInteractionLibrary::FindActorInteractionData(const AActor* Actor)
+{
+	if (IsValid(Actor))
+	{
+		if (const UInteractableComponent* InteractableComponent = FindInteractableComponent(Actor))
+		{
+			return &InteractableComponent->InteractionData;
+		}
+	}
+
+	if (!IsValid(Actor) || !Actor->Implements<UTrickyInteractionInterface>())
 	{
 #if WITH_EDITOR && !UE_BUILD_SHIPPING
-		if (!IsValid(Actor))
+		if (IsValid(Actor))
 		{
 			const FString ActorName = Actor->GetActorNameOrLabel();
 			const FString Instruction = FString::Printf(
@@ -39,44 +116,185 @@ bool UTrickyInteractionLibrary::GetActorInteractionData(AActor* Actor, FInteract
 			PrintError("Can't get interaction data. Actor is invalid.");
 		}
 #endif
-		return false;
+		return nullptr;
 	}
 
-	const FName InteractionDataPropertyName = "InteractionData";
-	const UClass* Class = Actor->GetClass();
+	const FInteractionDataProperties& Properties = FindInteractionDataProperties(Actor->GetClass());
 
-	FProperty* Property = Class->FindPropertyByName(InteractionDataPropertyName);
+	if (Properties.DefinitionProperty)
+	{
+		const UInteractionDefinition* Definition = Cast<UInteractionDefinition>(
+			Properties.DefinitionProperty->GetObjectPropertyValue_InContainer(Actor));
 
-	if (!Property)
+		if (IsValid(Definition))
+		{
+			const UInteractionDataOverrides* Overrides = Properties.OverridesProperty
+				                                             ? Cast<UInteractionDataOverrides>(
+					                                             Properties.OverridesProperty->
+					                                             GetObjectPropertyValue_InContainer(Actor))
+				                                             : nullptr;
+
+			if (!Overrides || !Overrides->HasAnyOverride())
+			{
+				return &Definition->GetInteractionData();
+			}
+
+			return &Overrides->GetMergedData(Definition);
+		}
+	}
+
+	if (!Properties.DataProperty)
 	{
 #if WITH_EDITOR && !UE_BUILD_SHIPPING
-		PrintPropertyError(Actor);
+		// Actors with a definition property don't need the InteractionData property, they only miss the definition
+		if (Properties.DefinitionProperty)
+		{
+			PrintError(FString::Printf(TEXT("Actor %s does NOT have InteractionDefinition set."),
+			                           *Actor->GetActorNameOrLabel()));
+		}
+		else
+		{
+			PrintPropertyError(Actor);
+		}
 #endif
-		return false;
+		return nullptr;
 	}
 
-	const FStructProperty* StructProperty = CastField<FStructProperty>(Property);
+	return Properties.DataProperty->ContainerPtrToValuePtr<FInteractionData>(Actor);
+}
 
-	if (!StructProperty)
+const FInteractionDataProperties& UTrickyInteractionLibrary::FindInteractionDataProperties(const UClass* Class)
+{
+	if (const FInteractionDataProperties* CachedProperties = InteractionDataPropertiesCache.Find(Class))
 	{
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-		PrintPropertyError(Actor);
-#endif
-		return false;
+		return *CachedProperties;
 	}
 
-	const FName StructName = StructProperty->Struct->GetFName();
+	BindInteractionDataPropertiesCacheInvalidation();
 
-	if (StructName != InteractionDataPropertyName)
+	FInteractionDataProperties Properties;
+
+	const FStructProperty* DataProperty = CastField<FStructProperty>(
+		Class->FindPropertyByName(TEXT("InteractionData")));
+
+	if (DataProperty && DataProperty->Struct == FInteractionData::StaticStruct())
 	{
-#if WITH_EDITOR && !UE_BUILD_SHIPPING
-		PrintPropertyError(Actor);
-#endif
-		return false;
+		Properties.DataProperty = DataProperty;
 	}
 
-	InteractionData = *StructProperty->ContainerPtrToValuePtr<FInteractionData>(Actor);
-	return true;
+	const FObjectProperty* DefinitionProperty = CastField<FObjectProperty>(
+		Class->FindPropertyByName(TEXT("InteractionDefinition")));
+
+	if (DefinitionProperty && DefinitionProperty->PropertyClass->IsChildOf<UInteractionDefinition>())
+	{
+		Properties.DefinitionProperty = DefinitionProperty;
+	}
+
+	const FObjectProperty* OverridesProperty = CastField<FObjectProperty>(
+		Class->FindPropertyByName(TEXT("InteractionOverrides")));
+
+	if (OverridesProperty && OverridesProperty->PropertyClass->IsChildOf<UInteractionDataOverrides>())
+	{
+		Properties.OverridesProperty = OverridesProperty;
+	}
+
+	return InteractionDataPropertiesCache.Add(Class, Properties);
+}
+
+const UInteractionDefinition* UTrickyInteractionLibrary::FindActorInteractionDefinition(const AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return nullptr;
+	}
+
+	const FInteractionDataProperties& Properties = FindInteractionDataProperties(Actor->GetClass());
+
+	if (!Properties.DefinitionProperty)
+	{
+		return nullptr;
+	}
+
+	const UInteractionDefinition* Definition = Cast<UInteractionDefinition>(
+		Properties.DefinitionProperty->GetObjectPropertyValue_InContainer(Actor));
+	return IsValid(Definition) ? Definition : nullptr;
+}
+
+UInteractableComponent* UTrickyInteractionLibrary::FindInteractableComponent(const AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return nullptr;
+	}
+
+	const UWorld* World = Actor->GetWorld();
+	const UTrickyInteractionSubsystem* Subsystem = World ? World->GetSubsystem<UTrickyInteractionSubsystem>() : nullptr;
+
+	return Subsystem
+		       ? Subsystem->FindInteractableComponent(Actor)
+		       : Actor->FindComponentByClass<UInteractableComponent>();
+}
+
+EInteractionResult UTrickyInteractionLibrary::ExecuteStartInteraction(AActor* InteractiveActor, AActor* Interactor)
+{
+	if (const UInteractableComponent* InteractableComponent = FindInteractableComponent(InteractiveActor))
+	{
+		return InteractableComponent->StartInteraction(Interactor);
+	}
+
+	if (!IsValid(InteractiveActor) || !InteractiveActor->Implements<UTrickyInteractionInterface>())
+	{
+		return EInteractionResult::Invalid;
+	}
+
+	return ITrickyInteractionInterface::Execute_StartInteraction(InteractiveActor, Interactor);
+}
+
+EInteractionResult UTrickyInteractionLibrary::ExecuteInterruptInteraction(AActor* InteractiveActor,
+                                                                          AActor* Interruptor,
+                                                                          AActor* Interactor)
+{
+	if (const UInteractableComponent* InteractableComponent = FindInteractableComponent(InteractiveActor))
+	{
+		return InteractableComponent->InterruptInteraction(Interruptor, Interactor);
+	}
+
+	if (!IsValid(InteractiveActor) || !InteractiveActor->Implements<UTrickyInteractionInterface>())
+	{
+		return EInteractionResult::Invalid;
+	}
+
+	return ITrickyInteractionInterface::Execute_InterruptInteraction(InteractiveActor, Interruptor, Interactor);
+}
+
+EInteractionResult UTrickyInteractionLibrary::ExecuteFinishInteraction(AActor* InteractiveActor, AActor* Interactor)
+{
+	if (const UInteractableComponent* InteractableComponent = FindInteractableComponent(InteractiveActor))
+	{
+		return InteractableComponent->FinishInteraction(Interactor);
+	}
+
+	if (!IsValid(InteractiveActor) || !InteractiveActor->Implements<UTrickyInteractionInterface>())
+	{
+		return EInteractionResult::Invalid;
+	}
+
+	return ITrickyInteractionInterface::Execute_FinishInteraction(InteractiveActor, Interactor);
+}
+
+EInteractionResult UTrickyInteractionLibrary::ExecuteForceInteraction(AActor* InteractiveActor, AActor* Interactor)
+{
+	if (const UInteractableComponent* InteractableComponent = FindInteractableComponent(InteractiveActor))
+	{
+		return InteractableComponent->ForceInteraction(Interactor);
+	}
+
+	if (!IsValid(InteractiveActor) || !InteractiveActor->Implements<UTrickyInteractionInterface>())
+	{
+		return EInteractionResult::Invalid;
+	}
+
+	return ITrickyInteractionInterface::Execute_ForceInteraction(InteractiveActor, Interactor);
 }
 
 bool UTrickyInteractionLibrary::AddToInteractionQueue(AActor* Interactor, AActor* InteractiveActor)
@@ -153,6 +371,27 @@ bool UTrickyInteractionLibrary::RemoveFromInteractionQueue(AActor* Interactor, A
 	return InteractionQueueComp->RemoveFromInteractionQueue(InteractiveActor);
 }
 
+int32 UTrickyInteractionLibrary::RemoveFromAllInteractionQueues(AActor* InteractiveActor, AActor* Interruptor)
+{
+	if (!InteractiveActor)
+	{
+#if WITH_EDITOR && !UE_BUILD_SHIPPING
+		PrintWarning("Can't remove InteractiveActor from all InteractionQueues. InteractiveActor is invalid.");
+#endif
+		return 0;
+	}
+
+	const UWorld* World = InteractiveActor->GetWorld();
+	UTrickyInteractionSubsystem* Subsystem = World ? World->GetSubsystem<UTrickyInteractionSubsystem>() : nullptr;
+
+	if (!IsValid(Subsystem))
+	{
+		return 0;
+	}
+
+	return Subsystem->RemoveFromAllInteractionQueues(InteractiveActor, Interruptor);
+}
+
 UInteractionQueueComponent* UTrickyInteractionLibrary::GetInteractionQueueComponent(const AActor* Actor)
 {
 	if (!IsValid(Actor))
@@ -200,6 +439,16 @@ bool UTrickyInteractionLibrary::IsInInteractionQueue(const AActor* Interactor, A
 	return InteractionQueueComp->IsInInteractionQueue(Actor);
 }
 
+void UTrickyInteractionLibrary::SetInteractionQuality(const int32 Quality)
+{
+	FInteractionScalability::SetQuality(Quality);
+}
+
+int32 UTrickyInteractionLibrary::GetInteractionQuality()
+{
+	return FInteractionScalability::GetQuality();
+}
+
 #if WITH_EDITOR && !UE_BUILD_SHIPPING
 void UTrickyInteractionLibrary::PrintWarning(const FString& Message)
 {
@@ -215,9 +464,9 @@ void UTrickyInteractionLibrary::PrintPropertyError(const AActor* Actor)
 {
 	const FString ActorName = Actor->GetActorNameOrLabel();
 	const FString Instruction = FString::Printf(
-		TEXT("Please add InteractionData variable to this actor if you want to use it as interactive actor."));
+		TEXT("Please add InteractionData or InteractionDefinition variable to this actor if you want to use it as interactive actor."));
 	const FString Message = FString::Printf(
-		TEXT("Actor %s does NOT have InteractionData property.\n%s"), *ActorName, *Instruction);
+		TEXT("Actor %s does NOT have InteractionData or InteractionDefinition property.\n%s"), *ActorName, *Instruction);
 	PrintError(Message);
 }
 #endif
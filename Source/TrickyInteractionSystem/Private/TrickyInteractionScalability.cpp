@@ -0,0 +1,148 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyInteractionScalability.h"
+
+#include "InteractionQueueComponent.h"
+#include "TrickyInteractionSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static void HandleScalabilityVariableChanged(IConsoleVariable* Variable);
+
+static void HandleQualityChanged(IConsoleVariable* Variable);
+
+static TAutoConsoleVariable<int32> CVarInteractionQuality(
+	TEXT("TrickyInteraction.Quality"),
+	2,
+	TEXT("Quality profile of the interaction system. 0 Low, 1 Medium, 2 High, 3 Epic."),
+	FConsoleVariableDelegate::CreateStatic(&HandleQualityChanged));
+
+static TAutoConsoleVariable<float> CVarInteractionTickInterval(
+	TEXT("TrickyInteraction.TickInterval"),
+	0.1f,
+	TEXT("Interval in seconds of the line of sight ticks of interaction queue components."),
+	FConsoleVariableDelegate::CreateStatic(&HandleScalabilityVariableChanged));
+
+static TAutoConsoleVariable<int32> CVarInteractionTraceBudget(
+	TEXT("TrickyInteraction.TraceBudget"),
+	0,
+	TEXT("Max number of line of sight traces per frame in a world. Components over the budget keep their last result. 0 is unlimited."),
+	FConsoleVariableDelegate::CreateStatic(&HandleScalabilityVariableChanged));
+
+static TAutoConsoleVariable<float> CVarInteractionTraceDistanceScale(
+	TEXT("TrickyInteraction.TraceDistanceScale"),
+	1.f,
+	TEXT("Scale of LineOfSightDistance of interaction queue components."),
+	FConsoleVariableDelegate::CreateStatic(&HandleScalabilityVariableChanged));
+
+static TAutoConsoleVariable<float> CVarInteractionTraceRadiusScale(
+	TEXT("TrickyInteraction.TraceRadiusScale"),
+	1.f,
+	TEXT("Scale of LineOfSightRadius of interaction queue components."),
+	FConsoleVariableDelegate::CreateStatic(&HandleScalabilityVariableChanged));
+
+static TAutoConsoleVariable<int32> CVarInteractionSortInterval(
+	TEXT("TrickyInteraction.SortInterval"),
+	1,
+	TEXT("Number of line of sight ticks between the sorts of the interaction queue. 1 sorts on every tick."),
+	FConsoleVariableDelegate::CreateStatic(&HandleScalabilityVariableChanged));
+
+/**
+ * Values of the quality levels, the High level matches the defaults of the console variables
+ */
+struct FInteractionQualityProfile
+{
+	float TickInterval;
+
+	int32 TraceBudget;
+
+	float TraceDistanceScale;
+
+	float TraceRadiusScale;
+
+	int32 SortInterval;
+};
+
+static constexpr FInteractionQualityProfile QualityProfiles[FInteractionScalability::QualityLevelsNum] = {
+	{0.25f, 16, 0.75f, 0.5f, 4},
+	{0.15f, 64, 1.f, 0.75f, 2},
+	{0.1f, 0, 1.f, 1.f, 1},
+	{0.05f, 0, 1.f, 1.f, 1}
+};
+
+static void HandleQualityChanged(IConsoleVariable* Variable)
+{
+	const int32 Quality = FMath::Clamp(Variable->GetInt(), 0, FInteractionScalability::QualityLevelsNum - 1);
+	const FInteractionQualityProfile& Profile = QualityProfiles[Quality];
+
+	// Each Set calls HandleScalabilityVariableChanged, the components are updated by the last one
+	CVarInteractionTickInterval->Set(Profile.TickInterval, ECVF_SetByScalability);
+	CVarInteractionTraceBudget->Set(Profile.TraceBudget, ECVF_SetByScalability);
+	CVarInteractionTraceDistanceScale->Set(Profile.TraceDistanceScale, ECVF_SetByScalability);
+	CVarInteractionTraceRadiusScale->Set(Profile.TraceRadiusScale, ECVF_SetByScalability);
+	CVarInteractionSortInterval->Set(Profile.SortInterval, ECVF_SetByScalability);
+}
+
+static void HandleScalabilityVariableChanged(IConsoleVariable* Variable)
+{
+	if (!GEngine)
+	{
+		return;
+	}
+
+	for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+	{
+		UWorld* World = WorldContext.World();
+		UTrickyInteractionSubsystem* Subsystem = World ? World->GetSubsystem<UTrickyInteractionSubsystem>() : nullptr;
+
+		if (!Subsystem)
+		{
+			continue;
+		}
+
+		TArray<UInteractionQueueComponent*> Components;
+		Subsystem->GetQueueComponents(Components);
+
+		for (UInteractionQueueComponent* Component : Components)
+		{
+			Component->ApplyScalabilitySettings();
+		}
+	}
+}
+
+int32 FInteractionScalability::GetQuality()
+{
+	return FMath::Clamp(CVarInteractionQuality.GetValueOnGameThread(), 0, QualityLevelsNum - 1);
+}
+
+void FInteractionScalability::SetQuality(const int32 Quality)
+{
+	CVarInteractionQuality->Set(FMath::Clamp(Quality, 0, QualityLevelsNum - 1), ECVF_SetByConsole);
+}
+
+float FInteractionScalability::GetTickInterval()
+{
+	return FMath::Max(CVarInteractionTickInterval.GetValueOnGameThread(), 0.f);
+}
+
+int32 FInteractionScalability::GetTraceBudget()
+{
+	return FMath::Max(CVarInteractionTraceBudget.GetValueOnGameThread(), 0);
+}
+
+float FInteractionScalability::GetTraceDistanceScale()
+{
+	return FMath::Max(CVarInteractionTraceDistanceScale.GetValueOnGameThread(), 0.f);
+}
+
+float FInteractionScalability::GetTraceRadiusScale()
+{
+	return FMath::Max(CVarInteractionTraceRadiusScale.GetValueOnGameThread(), 0.f);
+}
+
+int32 FInteractionScalability::GetSortInterval()
+{
+	return FMath::Max(CVarInteractionSortInterval.GetValueOnGameThread(), 1);
+}
@@ -0,0 +1,10 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyInteractionStats.h"
+
+int64 FInteractionPerfCounters::TracesNum = 0;
+
+int64 FInteractionPerfCounters::ContainerAllocationsNum = 0;
+
+double FInteractionPerfCounters::TickSeconds = 0.0;
@@ -0,0 +1,1204 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyInteractionSubsystem.h"
+
+#include "InteractableComponent.h"
+#include "InteractionQueueComponent.h"
+#include "TrickyInteractionLibrary.h"
+#include "TrickyInteractionScalability.h"
+#include "TrickyInteractionStats.h"
+#include "Engine/Engine.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+
+DECLARE_CYCLE_STAT(TEXT("Register Level Actors"), STAT_InteractionRegisterLevelActors, STATGROUP_TrickyInteraction);
+DECLARE_CYCLE_STAT(TEXT("Purge Level Actors"), STAT_InteractionPurgeLevelActors, STATGROUP_TrickyInteraction);
+DECLARE_CYCLE_STAT(TEXT("Deferred Queue Adds"), STAT_InteractionDeferredQueueAdds, STATGROUP_TrickyInteraction);
+DECLARE_CYCLE_STAT(TEXT("Timed Interactions"), STAT_InteractionTimedInteractions, STATGROUP_TrickyInteraction);
+DECLARE_CYCLE_STAT(TEXT("Raycast Interactive Bounds"), STAT_InteractionRaycastBounds, STATGROUP_TrickyInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Traces Over Budget"), STAT_InteractionTracesOverBudget, STATGROUP_TrickyInteraction);
+
+static TAutoConsoleVariable<float> CVarLevelRegistrationBudgetMs(
+	TEXT("TrickyInteraction.LevelRegistrationBudgetMs"),
+	0.5f,
+	TEXT("Time budget per frame in milliseconds for registering interactive actors of loaded levels. 0 registers the whole level at once."));
+
+void UTrickyInteractionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(
+		this, &UTrickyInteractionSubsystem::HandleWorldPostActorTick);
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(
+		this, &UTrickyInteractionSubsystem::HandleLevelAddedToWorld);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(
+		this, &UTrickyInteractionSubsystem::HandleLevelRemovedFromWorld);
+}
+
+void UTrickyInteractionSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+		World->RemoveOnActorDestroyededHandler(ActorDestroyedHandle);
+	}
+
+	StopRecording();
+	StopReplay();
+	PendingFlushComponents.Empty();
+	FlushingComponents.Empty();
+	QueueComponents.Empty();
+	InteractableComponents.Empty();
+	QueueHolders.Empty();
+	Reservations.Empty();
+	RegisteredActors.Empty();
+	InteractiveBounds.Reset();
+	PendingLevelRegistrations.Empty();
+	DeferredQueueAdds.Empty();
+	TraceBudget.Reset();
+	PersistentActorIds.Empty();
+	PersistentIdActors.Empty();
+
+	Super::Deinitialize();
+}
+
+void UTrickyInteractionSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(
+		FOnActorSpawned::FDelegate::CreateUObject(this, &UTrickyInteractionSubsystem::HandleActorSpawned));
+	ActorDestroyedHandle = InWorld.AddOnActorDestroyedHandler(
+		FOnActorDestroyed::FDelegate::CreateUObject(this, &UTrickyInteractionSubsystem::HandleActorDestroyed));
+
+	// Levels loaded before BeginPlay don't trigger LevelAddedToWorld for this subsystem
+	for (ULevel* Level : InWorld.GetLevels())
+	{
+		HandleLevelAddedToWorld(Level, &InWorld);
+	}
+}
+
+void UTrickyInteractionSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	const FInteractionPerfCounters::FTickTimeScope TickTimeScope;
+
+	ProcessPendingLevelRegistrations();
+	ProcessDeferredQueueAdds();
+	ProcessExpiredTimedInteractions();
+	ProcessExpiredReservations();
+	ProcessReplay();
+}
+
+TStatId UTrickyInteractionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTrickyInteractionSubsystem, STATGROUP_TrickyInteraction);
+}
+
+void UTrickyInteractionSubsystem::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	SIZE_T AllocatedSize = QueueHolders.GetAllocatedSize()
+		+ QueueComponents.GetAllocatedSize()
+		+ InteractableComponents.GetAllocatedSize()
+		+ PendingFlushComponents.GetAllocatedSize()
+		+ FlushingComponents.GetAllocatedSize()
+		+ RegisteredActors.GetAllocatedSize()
+		+ PendingLevelRegistrations.GetAllocatedSize()
+		+ DeferredQueueAdds.GetAllocatedSize()
+		+ TraceBudget.GetAllocatedSize()
+		+ PersistentActorIds.GetAllocatedSize()
+		+ PersistentIdActors.GetAllocatedSize()
+		+ InteractiveBounds.GetAllocatedSize()
+		+ TimedInteractionsWheel.GetAllocatedSize()
+		+ ExpiredTimedInteractions.GetAllocatedSize()
+		+ Reservations.GetAllocatedSize()
+		+ ReservationTimeoutsWheel.GetAllocatedSize()
+		+ ExpiredReservations.GetAllocatedSize();
+
+	for (const TPair<TObjectKey<AActor>, FQueueHolders>& Pair : QueueHolders)
+	{
+		AllocatedSize += Pair.Value.GetAllocatedSize();
+	}
+
+	for (const TPair<TObjectKey<AActor>, FInteractionReservation>& Pair : Reservations)
+	{
+		AllocatedSize += Pair.Value.Claims.GetAllocatedSize();
+	}
+
+	for (const TPair<TWeakObjectPtr<UInteractionQueueComponent>, TArray<TWeakObjectPtr<AActor>>>& Pair :
+	     DeferredQueueAdds)
+	{
+		AllocatedSize += Pair.Value.GetAllocatedSize();
+	}
+
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(AllocatedSize);
+}
+
+void UTrickyInteractionSubsystem::RequestEventsFlush(UInteractionQueueComponent* Component)
+{
+	if (!IsValid(Component))
+	{
+		return;
+	}
+
+	PendingFlushComponents.Emplace(Component);
+}
+
+void UTrickyInteractionSubsystem::RegisterQueueComponent(UInteractionQueueComponent* Component)
+{
+	if (!IsValid(Component))
+	{
+		return;
+	}
+
+	QueueComponents.AddUnique(Component);
+	OnQueueComponentRegistered.Broadcast(this, Component);
+}
+
+void UTrickyInteractionSubsystem::UnregisterQueueComponent(UInteractionQueueComponent* Component)
+{
+	QueueComponents.RemoveSingleSwap(Component, EAllowShrinking::No);
+	DeferredQueueAdds.Remove(Component);
+	TraceBudget.Remove(Component);
+}
+
+void UTrickyInteractionSubsystem::GetQueueComponents(TArray<UInteractionQueueComponent*>& OutComponents) const
+{
+	OutComponents.Reset(QueueComponents.Num());
+
+	for (const TWeakObjectPtr<UInteractionQueueComponent>& Component : QueueComponents)
+	{
+		if (Component.IsValid())
+		{
+			OutComponents.Add(Component.Get());
+		}
+	}
+}
+
+void UTrickyInteractionSubsystem::RegisterInteractableComponent(UInteractableComponent* Component)
+{
+	if (!IsValid(Component) || !IsValid(Component->GetOwner()))
+	{
+		return;
+	}
+
+	// The first interactable component of the actor is used
+	TWeakObjectPtr<UInteractableComponent>& CachedComponent = InteractableComponents.FindOrAdd(Component->GetOwner());
+
+	if (!CachedComponent.IsValid())
+	{
+		CachedComponent = Component;
+	}
+}
+
+void UTrickyInteractionSubsystem::UnregisterInteractableComponent(const UInteractableComponent* Component)
+{
+	if (!Component)
+	{
+		return;
+	}
+
+	AActor* Owner = Component->GetOwner();
+	TWeakObjectPtr<UInteractableComponent>* CachedComponent = InteractableComponents.Find(Owner);
+
+	if (!CachedComponent || CachedComponent->Get() != Component)
+	{
+		return;
+	}
+
+	// Another registered interactable component of the actor takes over, so the actor stays interactive
+	if (IsValid(Owner))
+	{
+		TInlineComponentArray<UInteractableComponent*> OwnerComponents(Owner);
+
+		for (UInteractableComponent* OwnerComponent : OwnerComponents)
+		{
+			if (OwnerComponent != Component && OwnerComponent->IsRegistered())
+			{
+				*CachedComponent = OwnerComponent;
+				return;
+			}
+		}
+	}
+
+	InteractableComponents.Remove(Owner);
+}
+
+UInteractableComponent* UTrickyInteractionSubsystem::FindInteractableComponent(const AActor* Actor) const
+{
+	const TWeakObjectPtr<UInteractableComponent>* CachedComponent = InteractableComponents.Find(Actor);
+	return CachedComponent ? CachedComponent->Get() : nullptr;
+}
+
+void UTrickyInteractionSubsystem::SaveInteractionState(TArray<uint8>& OutData) const
+{
+	TArray<UInteractionQueueComponent*> Components;
+	GetQueueComponents(Components);
+
+	FInteractionWorldSavedState SavedState;
+	SavedState.Entries.Reserve(Components.Num());
+
+	for (UInteractionQueueComponent* Component : Components)
+	{
+		const FInteractionActorId OwnerId = MakeActorId(Component->GetOwner());
+
+		if (!OwnerId.IsValid())
+		{
+#if WITH_EDITOR && !UE_BUILD_SHIPPING
+			UE_LOG(LogTrickyInteractionSystem, Log,
+			       TEXT("InteractionQueue of %s isn't saved. Its owner was spawned at runtime and has no persistent ID."),
+			       *Component->GetOwner()->GetActorNameOrLabel());
+#endif
+			continue;
+		}
+
+		FInteractionWorldSavedState::FEntry& Entry = SavedState.Entries.AddDefaulted_GetRef();
+		Entry.OwnerId = OwnerId;
+		Entry.ComponentName = Component->GetFName();
+		Component->SaveInteractionState(Entry.Data);
+	}
+
+	SavedState.Write(OutData);
+}
+
+int32 UTrickyInteractionSubsystem::RestoreInteractionState(const TArray<uint8>& Data)
+{
+	FInteractionWorldSavedState SavedState;
+
+	if (!SavedState.Read(Data))
+	{
+		return INDEX_NONE;
+	}
+
+	int32 RestoredNum = 0;
+
+	for (const FInteractionWorldSavedState::FEntry& Entry : SavedState.Entries)
+	{
+		AActor* Owner = ResolveActorId(Entry.OwnerId);
+
+		if (!IsValid(Owner))
+		{
+			continue;
+		}
+
+		TInlineComponentArray<UInteractionQueueComponent*> OwnerComponents(Owner);
+
+		for (UInteractionQueueComponent* Component : OwnerComponents)
+		{
+			if (Component->GetFName() == Entry.ComponentName)
+			{
+				RestoredNum += Component->RestoreInteractionState(Entry.Data) ? 1 : 0;
+				break;
+			}
+		}
+	}
+
+	return RestoredNum;
+}
+
+void UTrickyInteractionSubsystem::SetPersistentActorId(AActor* Actor, const FGuid& Id)
+{
+	if (!Actor)
+	{
+		return;
+	}
+
+	FGuid PreviousId;
+
+	if (PersistentActorIds.RemoveAndCopyValue(Actor, PreviousId))
+	{
+		PersistentIdActors.Remove(PreviousId);
+	}
+
+	if (!Id.IsValid())
+	{
+		return;
+	}
+
+	// The ID moves to the new actor, e.g. when a destroyed actor is respawned before its destruction is handled
+	TWeakObjectPtr<AActor> PreviousActor;
+
+	if (PersistentIdActors.RemoveAndCopyValue(Id, PreviousActor))
+	{
+		PersistentActorIds.Remove(PreviousActor.Get());
+	}
+
+	PersistentActorIds.Add(Actor, Id);
+	PersistentIdActors.Add(Id, Actor);
+}
+
+FGuid UTrickyInteractionSubsystem::GetPersistentActorId(const AActor* Actor) const
+{
+	const FGuid* Id = PersistentActorIds.Find(Actor);
+	return Id ? *Id : FGuid();
+}
+
+FInteractionActorId UTrickyInteractionSubsystem::MakeActorId(const AActor* Actor) const
+{
+	FInteractionActorId ActorId;
+
+	if (!Actor)
+	{
+		return ActorId;
+	}
+
+	ActorId.Guid = GetPersistentActorId(Actor);
+
+	// Spawned actors get new names, so only the paths of the actors loaded with their level are stable
+	if (!ActorId.Guid.IsValid() && (Actor->HasAnyFlags(RF_WasLoaded) || Actor->IsNetStartupActor()))
+	{
+		ActorId.Path = FSoftObjectPath(UWorld::RemovePIEPrefix(FSoftObjectPath(Actor).ToString()));
+	}
+
+	return ActorId;
+}
+
+AActor* UTrickyInteractionSubsystem::ResolveActorId(const FInteractionActorId& ActorId) const
+{
+	if (ActorId.Guid.IsValid())
+	{
+		const TWeakObjectPtr<AActor>* Actor = PersistentIdActors.Find(ActorId.Guid);
+		return Actor ? Actor->Get() : nullptr;
+	}
+
+	if (!ActorId.Path.IsValid())
+	{
+		return nullptr;
+	}
+
+	FSoftObjectPath ActorPath = ActorId.Path;
+
+#if WITH_EDITOR
+	const FWorldContext* WorldContext = GEngine ? GEngine->GetWorldContextFromWorld(GetWorld()) : nullptr;
+
+	if (WorldContext && WorldContext->WorldType == EWorldType::PIE)
+	{
+		ActorPath.FixupForPIE(WorldContext->PIEInstance);
+	}
+#endif
+
+	return Cast<AActor>(ActorPath.ResolveObject());
+}
+
+void UTrickyInteractionSubsystem::RegisterQueueEntry(AActor* InteractiveActor, UInteractionQueueComponent* Component)
+{
+	if (!InteractiveActor || !IsValid(Component))
+	{
+		return;
+	}
+
+	QueueHolders.FindOrAdd(InteractiveActor).AddUnique(Component);
+
+	// Queued actors are picked by the bounds backend even when they aren't registered as interactive
+	InteractiveBounds.AddActor(InteractiveActor);
+}
+
+void UTrickyInteractionSubsystem::UnregisterQueueEntry(AActor* InteractiveActor, UInteractionQueueComponent* Component)
+{
+	FQueueHolders* Holders = QueueHolders.Find(InteractiveActor);
+
+	if (!Holders)
+	{
+		return;
+	}
+
+	Holders->RemoveSwap(Component);
+
+	if (Holders->IsEmpty())
+	{
+		QueueHolders.Remove(InteractiveActor);
+
+		if (!RegisteredActors.Contains(InteractiveActor))
+		{
+			InteractiveBounds.RemoveActor(InteractiveActor);
+		}
+	}
+}
+
+bool UTrickyInteractionSubsystem::TryDeferQueueAdd(AActor* InteractiveActor, UInteractionQueueComponent* Component)
+{
+	const ULevel* Level = InteractiveActor ? InteractiveActor->GetLevel() : nullptr;
+
+	if (!Level || !IsValid(Component) || Level->IsPersistentLevel())
+	{
+		return false;
+	}
+
+	// The level is either still being made visible or its interactive actors are still being registered
+	if (Level->bIsVisible && !IsLevelRegistrationPending(Level))
+	{
+		return false;
+	}
+
+	DeferredQueueAdds.FindOrAdd(Component).AddUnique(InteractiveActor);
+	return true;
+}
+
+bool UTrickyInteractionSubsystem::CancelDeferredQueueAdd(const AActor* InteractiveActor,
+                                                         const UInteractionQueueComponent* Component)
+{
+	if (DeferredQueueAdds.IsEmpty())
+	{
+		return false;
+	}
+
+	TArray<TWeakObjectPtr<AActor>>* Actors = DeferredQueueAdds.Find(Component);
+	return Actors && Actors->RemoveSingleSwap(InteractiveActor, EAllowShrinking::No) > 0;
+}
+
+void UTrickyInteractionSubsystem::ProcessDeferredQueueAdds()
+{
+	if (DeferredQueueAdds.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_InteractionDeferredQueueAdds);
+
+	// Listeners of the added actors can defer new adds, they're processed next frame
+	const TMap<TWeakObjectPtr<UInteractionQueueComponent>, TArray<TWeakObjectPtr<AActor>>> QueueAdds =
+		MoveTemp(DeferredQueueAdds);
+	DeferredQueueAdds.Reset();
+	TGuardValue<bool> ProcessingGuard(bIsProcessingDeferredQueueAdds, true);
+	TArray<AActor*> Actors;
+
+	for (const TPair<TWeakObjectPtr<UInteractionQueueComponent>, TArray<TWeakObjectPtr<AActor>>>& Pair : QueueAdds)
+	{
+		UInteractionQueueComponent* Component = Pair.Key.Get();
+
+		if (!Component)
+		{
+			continue;
+		}
+
+		Actors.Reset();
+
+		for (const TWeakObjectPtr<AActor>& Actor : Pair.Value)
+		{
+			if (Actor.IsValid())
+			{
+				Actors.Add(Actor.Get());
+			}
+		}
+
+		Component->AddToInteractionQueueBatch(Actors);
+	}
+}
+
+void UTrickyInteractionSubsystem::GetInteractionQueueHolders(AActor* InteractiveActor,
+                                                             TArray<UInteractionQueueComponent*>& OutComponents) const
+{
+	OutComponents.Reset();
+	const FQueueHolders* Holders = QueueHolders.Find(InteractiveActor);
+
+	if (!Holders)
+	{
+		return;
+	}
+
+	for (const TWeakObjectPtr<UInteractionQueueComponent>& Holder : *Holders)
+	{
+		if (Holder.IsValid())
+		{
+			OutComponents.Add(Holder.Get());
+		}
+	}
+}
+
+int32 UTrickyInteractionSubsystem::RemoveFromAllInteractionQueues(AActor* InteractiveActor, AActor* Interruptor)
+{
+	const FQueueHolders* FoundHolders = QueueHolders.Find(InteractiveActor);
+
+	if (!InteractiveActor || !FoundHolders)
+	{
+		return 0;
+	}
+
+	// Removal updates the index, so iterate over a copy
+	const FQueueHolders Holders = *FoundHolders;
+	int32 RemovedNum = 0;
+
+	for (const TWeakObjectPtr<UInteractionQueueComponent>& Holder : Holders)
+	{
+		UInteractionQueueComponent* Component = Holder.Get();
+
+		if (!Component)
+		{
+			continue;
+		}
+
+		if (Component->GetActiveInteractionActor() == InteractiveActor)
+		{
+			Component->InterruptInteraction(Interruptor);
+		}
+
+		RemovedNum += Component->RemoveFromInteractionQueue(InteractiveActor) ? 1 : 0;
+	}
+
+	QueueHolders.Remove(InteractiveActor);
+
+	if (!RegisteredActors.Contains(InteractiveActor))
+	{
+		InteractiveBounds.RemoveActor(InteractiveActor);
+	}
+
+	return RemovedNum;
+}
+
+int32 UTrickyInteractionSubsystem::RemoveFromAllInteractionQueuesBatch(const TArray<AActor*>& InteractiveActors,
+                                                                      AActor* Interruptor)
+{
+	TMap<UInteractionQueueComponent*, TArray<AActor*>> ActorsPerComponent;
+
+	for (AActor* InteractiveActor : InteractiveActors)
+	{
+		const FQueueHolders* Holders = QueueHolders.Find(InteractiveActor);
+
+		if (!Holders)
+		{
+			continue;
+		}
+
+		for (const TWeakObjectPtr<UInteractionQueueComponent>& Holder : *Holders)
+		{
+			if (Holder.IsValid())
+			{
+				ActorsPerComponent.FindOrAdd(Holder.Get()).Add(InteractiveActor);
+			}
+		}
+	}
+
+	int32 RemovedNum = 0;
+
+	for (const TPair<UInteractionQueueComponent*, TArray<AActor*>>& Pair : ActorsPerComponent)
+	{
+		UInteractionQueueComponent* Component = Pair.Key;
+
+		if (Pair.Value.Contains(Component->GetActiveInteractionActor()))
+		{
+			Component->InterruptInteraction(Interruptor);
+		}
+
+		RemovedNum += Component->RemoveFromInteractionQueueBatch(Pair.Value);
+	}
+
+	return RemovedNum;
+}
+
+bool UTrickyInteractionSubsystem::IsInteractiveActorRegistered(AActor* Actor) const
+{
+	return RegisteredActors.Contains(Actor);
+}
+
+bool UTrickyInteractionSubsystem::IsLevelRegistrationPending(const ULevel* Level) const
+{
+	return PendingLevelRegistrations.ContainsByPredicate([Level](const FPendingLevelRegistration& Registration)
+	{
+		return Registration.Level == Level;
+	});
+}
+
+uint32 UTrickyInteractionSubsystem::ScheduleTimedInteraction(UInteractionQueueComponent* Component, const float Duration)
+{
+	if (!IsValid(Component) || Duration <= 0.f)
+	{
+		return 0;
+	}
+
+	return TimedInteractionsWheel.Schedule(GetWorld()->GetTimeSeconds() + Duration, Component);
+}
+
+void UTrickyInteractionSubsystem::CancelTimedInteraction(const uint32 Handle)
+{
+	TimedInteractionsWheel.Cancel(Handle);
+}
+
+void UTrickyInteractionSubsystem::ProcessExpiredTimedInteractions()
+{
+	SCOPE_CYCLE_COUNTER(STAT_InteractionTimedInteractions);
+
+	// Empty wheels are advanced too, so they don't sweep every slot after an idle period
+	TimedInteractionsWheel.Advance(GetWorld()->GetTimeSeconds(), ExpiredTimedInteractions);
+
+	for (const TPair<uint32, TWeakObjectPtr<UInteractionQueueComponent>>& Expired : ExpiredTimedInteractions)
+	{
+		if (UInteractionQueueComponent* Component = Expired.Value.Get())
+		{
+			Component->HandleTimedInteractionExpired(Expired.Key);
+		}
+	}
+
+	ExpiredTimedInteractions.Reset();
+}
+
+AActor* UTrickyInteractionSubsystem::RaycastInteractiveBounds(const FVector& Start,
+                                                             const FVector& End,
+                                                             const float Radius,
+                                                             TConstArrayView<AActor*> ActorsToIgnore,
+                                                             FVector& OutHitLocation)
+{
+	SCOPE_CYCLE_COUNTER(STAT_InteractionRaycastBounds);
+
+	// Insertions and removals are applied immediately, only movable actors are refitted once per frame
+	if (InteractiveBoundsUpdateFrame != GFrameCounter)
+	{
+		InteractiveBounds.Update();
+		InteractiveBoundsUpdateFrame = GFrameCounter;
+	}
+
+	return InteractiveBounds.Raycast(Start, End, Radius, ActorsToIgnore, OutHitLocation);
+}
+
+bool UTrickyInteractionSubsystem::TryConsumeTraceBudget(const UInteractionQueueComponent* Component)
+{
+	if (TraceBudget.TryConsume(Component, FInteractionScalability::GetTraceBudget(), GFrameCounter))
+	{
+		return true;
+	}
+
+	INC_DWORD_STAT(STAT_InteractionTracesOverBudget);
+	return false;
+}
+
+bool UTrickyInteractionSubsystem::TryReserveInteraction(AActor* InteractiveActor,
+                                                        UInteractionQueueComponent* Component,
+                                                        const float Timeout)
+{
+	if (!IsValid(InteractiveActor) || !IsValid(Component))
+	{
+		return false;
+	}
+
+	// The capacity is read on every claim, as the interaction data can change at runtime
+	const int32 Capacity = GetReservationCapacity(InteractiveActor);
+
+	// Actors with unlimited capacity don't need to be tracked
+	if (Capacity <= 0)
+	{
+		return true;
+	}
+
+	FInteractionReservation& Reservation = Reservations.FindOrAdd(InteractiveActor);
+
+	Reservation.Claims.RemoveAllSwap([](const FInteractionClaim& Claim)
+	{
+		return !Claim.Component.IsValid();
+	}, EAllowShrinking::No);
+
+	const bool bIsAlreadyClaimed = Reservation.Claims.ContainsByPredicate([Component](const FInteractionClaim& Claim)
+	{
+		return Claim.Component == Component;
+	});
+
+	if (bIsAlreadyClaimed)
+	{
+		return true;
+	}
+
+	if (Reservation.Claims.Num() >= Capacity)
+	{
+		return false;
+	}
+
+	FInteractionClaim Claim;
+	Claim.Component = Component;
+
+	if (Timeout > 0.f)
+	{
+		FReservationTimeout ReservationTimeout;
+		ReservationTimeout.InteractiveActor = InteractiveActor;
+		ReservationTimeout.Component = Component;
+		Claim.TimeoutHandle = ReservationTimeoutsWheel.Schedule(GetWorld()->GetTimeSeconds() + Timeout,
+		                                                        ReservationTimeout);
+	}
+
+	Reservation.Claims.Add(Claim);
+	return true;
+}
+
+void UTrickyInteractionSubsystem::ReleaseInteraction(AActor* InteractiveActor,
+                                                     const UInteractionQueueComponent* Component)
+{
+	FInteractionReservation* Reservation = Reservations.Find(InteractiveActor);
+
+	if (!Reservation)
+	{
+		return;
+	}
+
+	const int32 ClaimIndex = Reservation->Claims.IndexOfByPredicate([Component](const FInteractionClaim& Claim)
+	{
+		return Claim.Component == Component;
+	});
+
+	if (ClaimIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	ReservationTimeoutsWheel.Cancel(Reservation->Claims[ClaimIndex].TimeoutHandle);
+	Reservation->Claims.RemoveAtSwap(ClaimIndex, 1, EAllowShrinking::No);
+
+	if (Reservation->Claims.IsEmpty())
+	{
+		Reservations.Remove(InteractiveActor);
+	}
+}
+
+bool UTrickyInteractionSubsystem::IsInteractionFullyReserved(AActor* InteractiveActor,
+                                                             const UInteractionQueueComponent* Component) const
+{
+	const FInteractionReservation* Reservation = Reservations.Find(InteractiveActor);
+
+	if (!Reservation)
+	{
+		return false;
+	}
+
+	int32 OtherClaimsNum = 0;
+
+	for (const FInteractionClaim& Claim : Reservation->Claims)
+	{
+		if (Claim.Component == Component)
+		{
+			return false;
+		}
+
+		OtherClaimsNum += Claim.Component.IsValid() ? 1 : 0;
+	}
+
+	const int32 Capacity = GetReservationCapacity(InteractiveActor);
+	return Capacity > 0 && OtherClaimsNum >= Capacity;
+}
+
+int32 UTrickyInteractionSubsystem::GetInteractionReservationsNum(AActor* InteractiveActor) const
+{
+	const FInteractionReservation* Reservation = Reservations.Find(InteractiveActor);
+	return Reservation ? Reservation->Claims.Num() : 0;
+}
+
+void UTrickyInteractionSubsystem::ProcessExpiredReservations()
+{
+	ReservationTimeoutsWheel.Advance(GetWorld()->GetTimeSeconds(), ExpiredReservations);
+
+	for (const TPair<uint32, FReservationTimeout>& Expired : ExpiredReservations)
+	{
+		FInteractionReservation* Reservation = Reservations.Find(Expired.Value.InteractiveActor);
+
+		if (!Reservation)
+		{
+			continue;
+		}
+
+		const uint32 TimeoutHandle = Expired.Key;
+		Reservation->Claims.RemoveAllSwap([TimeoutHandle](const FInteractionClaim& Claim)
+		{
+			return Claim.TimeoutHandle == TimeoutHandle;
+		}, EAllowShrinking::No);
+
+		if (Reservation->Claims.IsEmpty())
+		{
+			Reservations.Remove(Expired.Value.InteractiveActor);
+		}
+
+		// The component must not keep an interaction which claim is gone
+		if (UInteractionQueueComponent* Component = Expired.Value.Component.Get())
+		{
+			Component->HandleReservationExpired(Expired.Value.InteractiveActor.ResolveObjectPtr());
+		}
+	}
+
+	ExpiredReservations.Reset();
+}
+
+int32 UTrickyInteractionSubsystem::GetReservationCapacity(AActor* InteractiveActor)
+{
+	const FInteractionData* InteractionData = UTrickyInteractionLibrary::FindActorInteractionData(InteractiveActor);
+	return InteractionData ? FMath::Max(InteractionData->MaxInteractors, 0) : 0;
+}
+
+void UTrickyInteractionSubsystem::RemoveReservation(const AActor* InteractiveActor)
+{
+	FInteractionReservation Reservation;
+
+	if (!Reservations.RemoveAndCopyValue(InteractiveActor, Reservation))
+	{
+		return;
+	}
+
+	for (const FInteractionClaim& Claim : Reservation.Claims)
+	{
+		ReservationTimeoutsWheel.Cancel(Claim.TimeoutHandle);
+	}
+}
+
+void UTrickyInteractionSubsystem::ProcessReplay()
+{
+	if (!Replayer.IsValid() || Replayer->Tick())
+	{
+		return;
+	}
+
+	UE_LOG(LogTrickyInteractionSystem, Display, TEXT("Interaction replay finished: %d records, %d divergences, %d unresolved"),
+	       Replayer->GetRecordsNum(),
+	       Replayer->GetDivergencesNum(),
+	       Replayer->GetUnresolvedNum());
+	Replayer.Reset();
+}
+
+bool UTrickyInteractionSubsystem::StartRecording(const FString& Filename)
+{
+	StopRecording();
+	Recorder = MakeUnique<FInteractionRecorder>();
+
+	if (!Recorder->Start(this, Filename))
+	{
+		Recorder.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+void UTrickyInteractionSubsystem::StopRecording()
+{
+	if (!Recorder.IsValid())
+	{
+		return;
+	}
+
+	UE_LOG(LogTrickyInteractionSystem, Display, TEXT("Interaction recording stopped: %d records, %lld bytes"),
+	       Recorder->GetRecordsNum(),
+	       Recorder->GetBytesWritten());
+	Recorder->Stop();
+	Recorder.Reset();
+}
+
+bool UTrickyInteractionSubsystem::StartReplay(const FString& Filename)
+{
+	StopReplay();
+	Replayer = MakeUnique<FInteractionReplayer>();
+
+	if (!Replayer->Start(GetWorld(), Filename))
+	{
+		Replayer.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+void UTrickyInteractionSubsystem::StopReplay()
+{
+	Replayer.Reset();
+}
+
+void UTrickyInteractionSubsystem::HandleLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	if (!Level || World != GetWorld() || IsLevelRegistrationPending(Level))
+	{
+		return;
+	}
+
+	FPendingLevelRegistration Registration;
+	Registration.Level = Level;
+	PendingLevelRegistrations.Add(Registration);
+}
+
+void UTrickyInteractionSubsystem::HandleLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	// Null level means the whole world is being cleaned up
+	if (!Level || World != GetWorld())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_InteractionPurgeLevelActors);
+
+	PendingLevelRegistrations.RemoveAll([Level](const FPendingLevelRegistration& Registration)
+	{
+		return Registration.Level == Level;
+	});
+
+	for (TPair<TWeakObjectPtr<UInteractionQueueComponent>, TArray<TWeakObjectPtr<AActor>>>& Pair : DeferredQueueAdds)
+	{
+		Pair.Value.RemoveAllSwap([Level](const TWeakObjectPtr<AActor>& Actor)
+		{
+			return !Actor.IsValid() || Actor->GetLevel() == Level;
+		});
+	}
+
+	TArray<AActor*> UnregisteredActors;
+	TArray<AActor*> QueuedActors;
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (!Actor)
+		{
+			continue;
+		}
+
+		if (RegisteredActors.Remove(Actor) > 0)
+		{
+			UnregisteredActors.Add(Actor);
+		}
+
+		InteractiveBounds.RemoveActor(Actor);
+
+		// Actors of a level which registration didn't finish can be queued through overlaps already
+		if (QueueHolders.Contains(Actor))
+		{
+			QueuedActors.Add(Actor);
+		}
+	}
+
+	if (!QueuedActors.IsEmpty())
+	{
+		RemoveFromAllInteractionQueuesBatch(QueuedActors, nullptr);
+	}
+
+	if (!UnregisteredActors.IsEmpty())
+	{
+		OnInteractiveActorsUnregistered.Broadcast(this, UnregisteredActors);
+	}
+}
+
+void UTrickyInteractionSubsystem::HandleActorSpawned(AActor* Actor)
+{
+	if (!UTrickyInteractionLibrary::IsActorInteractive(Actor))
+	{
+		return;
+	}
+
+	RegisteredActors.Add(Actor);
+	InteractiveBounds.AddActor(Actor);
+	OnInteractiveActorsRegistered.Broadcast(this, TConstArrayView<AActor*>(&Actor, 1));
+}
+
+void UTrickyInteractionSubsystem::HandleActorDestroyed(AActor* Actor)
+{
+	// Like the actors of an unloaded level, a destroyed actor leaves every queue and its reverse index entry
+	if (QueueHolders.Contains(Actor))
+	{
+		RemoveFromAllInteractionQueues(Actor, nullptr);
+		QueueHolders.Remove(Actor);
+	}
+
+	RegisteredActors.Remove(Actor);
+	InteractiveBounds.RemoveActor(Actor);
+	RemoveReservation(Actor);
+	SetPersistentActorId(Actor, FGuid());
+}
+
+void UTrickyInteractionSubsystem::ProcessPendingLevelRegistrations()
+{
+	if (PendingLevelRegistrations.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_InteractionRegisterLevelActors);
+
+	const float BudgetMs = CVarLevelRegistrationBudgetMs.GetValueOnGameThread();
+	const double EndTime = FPlatformTime::Seconds() + BudgetMs * 0.001;
+	constexpr int32 ActorsPerTimeCheck = 32;
+	TArray<AActor*> NewActors;
+	bool bIsBudgetExceeded = false;
+
+	while (!PendingLevelRegistrations.IsEmpty() && !bIsBudgetExceeded)
+	{
+		FPendingLevelRegistration& Registration = PendingLevelRegistrations[0];
+		const ULevel* Level = Registration.Level.Get();
+
+		if (!IsValid(Level))
+		{
+			PendingLevelRegistrations.RemoveAt(0);
+			continue;
+		}
+
+		while (Registration.NextActorIndex < Level->Actors.Num())
+		{
+			AActor* Actor = Level->Actors[Registration.NextActorIndex++];
+
+			if (UTrickyInteractionLibrary::IsActorInteractive(Actor) && !RegisteredActors.Contains(Actor))
+			{
+				RegisteredActors.Add(Actor);
+				InteractiveBounds.AddActor(Actor);
+				NewActors.Add(Actor);
+			}
+
+			if (BudgetMs > 0.f
+				&& Registration.NextActorIndex % ActorsPerTimeCheck == 0
+				&& FPlatformTime::Seconds() >= EndTime)
+			{
+				bIsBudgetExceeded = true;
+				break;
+			}
+		}
+
+		if (Registration.NextActorIndex >= Level->Actors.Num())
+		{
+			PendingLevelRegistrations.RemoveAt(0);
+		}
+	}
+
+	if (!NewActors.IsEmpty())
+	{
+		OnInteractiveActorsRegistered.Broadcast(this, NewActors);
+	}
+}
+
+void UTrickyInteractionSubsystem::HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaTime)
+{
+	if (World != GetWorld() || PendingFlushComponents.IsEmpty())
+	{
+		return;
+	}
+
+	const FInteractionPerfCounters::FTickTimeScope TickTimeScope;
+
+	// Components which get new events while flushing are requested again and flushed next frame
+	Swap(PendingFlushComponents, FlushingComponents);
+
+	for (const TWeakObjectPtr<UInteractionQueueComponent>& Component : FlushingComponents)
+	{
+		if (Component.IsValid())
+		{
+			Component->FlushPendingEvents();
+		}
+	}
+
+	FlushingComponents.Reset();
+}
+
+#if !UE_BUILD_SHIPPING
+static FString GetInteractionRecordingFilename(const TArray<FString>& Args)
+{
+	if (Args.IsValidIndex(0))
+	{
+		return FPaths::IsRelative(Args[0]) ? FPaths::ProfilingDir() / TEXT("Interaction") / Args[0] : Args[0];
+	}
+
+	return FPaths::ProfilingDir() / TEXT("Interaction") / FString::Printf(
+		TEXT("Interaction-%s.tirec"), *FDateTime::Now().ToString());
+}
+
+static void StartInteractionRecording(const TArray<FString>& Args, UWorld* World)
+{
+	UTrickyInteractionSubsystem* Subsystem = World ? World->GetSubsystem<UTrickyInteractionSubsystem>() : nullptr;
+
+	if (!Subsystem)
+	{
+		return;
+	}
+
+	const FString Filename = GetInteractionRecordingFilename(Args);
+
+	if (Subsystem->StartRecording(Filename))
+	{
+		UE_LOG(LogTrickyInteractionSystem, Display, TEXT("Interaction recording started: %s"), *Filename);
+	}
+	else
+	{
+		UE_LOG(LogTrickyInteractionSystem, Error, TEXT("Failed to start interaction recording: %s"), *Filename);
+	}
+}
+
+static void StopInteractionRecording(const TArray<FString>& Args, UWorld* World)
+{
+	if (UTrickyInteractionSubsystem* Subsystem = World ? World->GetSubsystem<UTrickyInteractionSubsystem>() : nullptr)
+	{
+		Subsystem->StopRecording();
+	}
+}
+
+static void StartInteractionReplay(const TArray<FString>& Args, UWorld* World)
+{
+	UTrickyInteractionSubsystem* Subsystem = World ? World->GetSubsystem<UTrickyInteractionSubsystem>() : nullptr;
+
+	if (!Subsystem || !Args.IsValidIndex(0))
+	{
+		UE_LOG(LogTrickyInteractionSystem, Warning, TEXT("Usage: TrickyInteraction.Replay <File>"));
+		return;
+	}
+
+	const FString Filename = GetInteractionRecordingFilename(Args);
+
+	if (Subsystem->StartReplay(Filename))
+	{
+		UE_LOG(LogTrickyInteractionSystem, Display, TEXT("Interaction replay started: %s"), *Filename);
+	}
+	else
+	{
+		UE_LOG(LogTrickyInteractionSystem, Error, TEXT("Failed to load interaction recording: %s"), *Filename);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs StartInteractionRecordingCommand(
+	TEXT("TrickyInteraction.Record.Start"),
+	TEXT("Starts recording interaction queue events. Optional argument is the file name, relative to the profiling directory."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StartInteractionRecording));
+
+static FAutoConsoleCommandWithWorldAndArgs StopInteractionRecordingCommand(
+	TEXT("TrickyInteraction.Record.Stop"),
+	TEXT("Stops recording interaction queue events."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StopInteractionRecording));
+
+static FAutoConsoleCommandWithWorldAndArgs StartInteractionReplayCommand(
+	TEXT("TrickyInteraction.Replay"),
+	TEXT("Replays a recording of interaction queue events in the current world. Argument is the file name."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StartInteractionReplay));
+
+static void DumpInteractionMemory()
+{
+	static int64 LastContainerAllocationsNum = 0;
+	const int64 ContainerAllocationsNum = FInteractionPerfCounters::ContainerAllocationsNum;
+
+	for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+	{
+		UWorld* World = WorldContext.World();
+		UTrickyInteractionSubsystem* Subsystem = World ? World->GetSubsystem<UTrickyInteractionSubsystem>() : nullptr;
+
+		if (!Subsystem)
+		{
+			continue;
+		}
+
+		TArray<UInteractionQueueComponent*> Components;
+		Subsystem->GetQueueComponents(Components);
+		SIZE_T ComponentsBytes = 0;
+
+		for (UInteractionQueueComponent* Component : Components)
+		{
+			ComponentsBytes += Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		}
+
+		const SIZE_T SubsystemBytes = Subsystem->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+
+		UE_LOG(LogTrickyInteractionSystem, Display, TEXT("Interaction memory of %s"), *World->GetName());
+		UE_LOG(LogTrickyInteractionSystem, Display, TEXT("  Queue components: %d (%llu heap bytes)"),
+		       Components.Num(), static_cast<uint64>(ComponentsBytes));
+		UE_LOG(LogTrickyInteractionSystem, Display, TEXT("  Subsystem: %llu heap bytes"), static_cast<uint64>(SubsystemBytes));
+		UE_LOG(LogTrickyInteractionSystem, Display, TEXT("  Total: %llu bytes"),
+		       static_cast<uint64>(ComponentsBytes + SubsystemBytes));
+	}
+
+	UE_LOG(LogTrickyInteractionSystem, Display, TEXT("Container allocations: %lld total, %lld since the last dump"),
+	       ContainerAllocationsNum, ContainerAllocationsNum - LastContainerAllocationsNum);
+	LastContainerAllocationsNum = ContainerAllocationsNum;
+}
+
+static FAutoConsoleCommand DumpInteractionMemoryCommand(
+	TEXT("TrickyInteraction.DumpMemory"),
+	TEXT("Prints the heap memory of interaction queue components and subsystems per world and the number of container allocations."),
+	FConsoleCommandDelegate::CreateStatic(&DumpInteractionMemory));
+#endif
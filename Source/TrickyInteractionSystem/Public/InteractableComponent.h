@@ -0,0 +1,107 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "TrickyInteractionInterface.h"
+#include "InteractableComponent.generated.h"
+
+DECLARE_DELEGATE_RetVal_OneParam(EInteractionResult, FInteractableHandlerSignature, AActor*);
+
+DECLARE_DELEGATE_RetVal_TwoParams(EInteractionResult, FInteractableInterruptHandlerSignature, AActor*, AActor*);
+
+/**
+ * Makes its owner interactive without ITrickyInteractionInterface and the InteractionData property
+ * The interaction data is read directly and the interaction is handled by native delegates, so no reflection is used.
+ * If a handler isn't bound, the call falls back to ITrickyInteractionInterface of the owner if it implements it.
+ */
+UCLASS(ClassGroup=(TrickyInteractionSystem), meta=(BlueprintSpawnableComponent))
+class TRICKYINTERACTIONSYSTEM_API UInteractableComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UInteractableComponent();
+
+	virtual void OnRegister() override;
+
+	virtual void OnUnregister() override;
+
+	/**
+	 * Interaction data of the owner. Used instead of the InteractionData property of the owner
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Interactable")
+	FInteractionData InteractionData;
+
+	EInteractionResult StartInteraction(AActor* Interactor) const;
+
+	EInteractionResult InterruptInteraction(AActor* Interruptor, AActor* Interactor) const;
+
+	EInteractionResult FinishInteraction(AActor* Interactor) const;
+
+	EInteractionResult ForceInteraction(AActor* Interactor) const;
+
+	/**
+	 * Binds a member function of a UObject or a native object as the start interaction handler
+	 */
+	template <typename UserClass>
+	void BindStartInteraction(UserClass* Object, EInteractionResult (UserClass::*Handler)(AActor*))
+	{
+		BindHandler(StartInteractionHandler, Object, Handler);
+	}
+
+	/**
+	 * Binds a member function of a UObject or a native object as the interrupt interaction handler
+	 */
+	template <typename UserClass>
+	void BindInterruptInteraction(UserClass* Object, EInteractionResult (UserClass::*Handler)(AActor*, AActor*))
+	{
+		BindHandler(InterruptInteractionHandler, Object, Handler);
+	}
+
+	/**
+	 * Binds a member function of a UObject or a native object as the finish interaction handler
+	 */
+	template <typename UserClass>
+	void BindFinishInteraction(UserClass* Object, EInteractionResult (UserClass::*Handler)(AActor*))
+	{
+		BindHandler(FinishInteractionHandler, Object, Handler);
+	}
+
+	/**
+	 * Binds a member function of a UObject or a native object as the force interaction handler
+	 */
+	template <typename UserClass>
+	void BindForceInteraction(UserClass* Object, EInteractionResult (UserClass::*Handler)(AActor*))
+	{
+		BindHandler(ForceInteractionHandler, Object, Handler);
+	}
+
+	/**
+	 * Unbinds all handlers, the interaction falls back to the interface of the owner
+	 */
+	void UnbindInteractionHandlers();
+
+	FInteractableHandlerSignature StartInteractionHandler;
+
+	FInteractableInterruptHandlerSignature InterruptInteractionHandler;
+
+	FInteractableHandlerSignature FinishInteractionHandler;
+
+	FInteractableHandlerSignature ForceInteractionHandler;
+
+private:
+	template <typename DelegateType, typename UserClass, typename HandlerType>
+	static void BindHandler(DelegateType& Delegate, UserClass* Object, HandlerType Handler)
+	{
+		if constexpr (TIsDerivedFrom<UserClass, UObject>::Value)
+		{
+			Delegate.BindUObject(Object, Handler);
+		}
+		else
+		{
+			Delegate.BindRaw(Object, Handler);
+		}
+	}
+};
@@ -0,0 +1,123 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+/**
+ * Bounding volume hierarchy which contains only the bounds of interactive actors
+ * Used by UTrickyInteractionSubsystem to pick interactive actors without sweeping the whole physics scene.
+ * Actors are inserted into and removed from the tree incrementally. Leaves of movable actors are enlarged by a margin,
+ * so an actor is reinserted only when it leaves the enlarged bounds of its leaf.
+ */
+class TRICKYINTERACTIONSYSTEM_API FInteractionBoundsHierarchy
+{
+public:
+	void AddActor(AActor* Actor);
+
+	void RemoveActor(const AActor* Actor);
+
+	bool Contains(const AActor* Actor) const { return EntryIndices.Contains(Actor); }
+
+	void Reset();
+
+	/**
+	 * Updates the bounds of movable actors and drops the actors which were destroyed without being removed
+	 */
+	void Update();
+
+	/**
+	 * Finds the closest actor which bounds are hit by a sphere moving along the ray
+	 * @param Start Start of the ray
+	 * @param End End of the ray
+	 * @param Radius Radius of the sphere. Bounds are expanded by it, so the test is conservative
+	 * @param ActorsToIgnore Actors which are skipped
+	 * @param OutHitLocation Point on the ray where it enters the bounds of the found actor
+	 * @return The closest actor or nullptr
+	 */
+	AActor* Raycast(const FVector& Start,
+	                const FVector& End,
+	                const float Radius,
+	                TConstArrayView<AActor*> ActorsToIgnore,
+	                FVector& OutHitLocation) const;
+
+	int32 Num() const { return Entries.Num(); }
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return Entries.GetAllocatedSize() + EntryIndices.GetAllocatedSize() + Nodes.GetAllocatedSize();
+	}
+
+#if WITH_DEV_AUTOMATION_TESTS
+	/**
+	 * Checks the links between the nodes and that every node contains the bounds of its children
+	 */
+	bool IsTreeValid() const;
+#endif
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<AActor> Actor = nullptr;
+
+		FObjectKey Key;
+
+		FBox Bounds = FBox(ForceInit);
+
+		int32 Leaf = INDEX_NONE;
+
+		bool bIsMovable = false;
+	};
+
+	struct FNode
+	{
+		/** Bounds of the children. Leaves of movable actors are enlarged by MovableBoundsMargin */
+		FBox Bounds = FBox(ForceInit);
+
+		/** Parent of the node or the next free node if the node is in the free list */
+		int32 Parent = INDEX_NONE;
+
+		int32 Children[2] = {INDEX_NONE, INDEX_NONE};
+
+		/** Entry of a leaf, INDEX_NONE for internal nodes */
+		int32 Entry = INDEX_NONE;
+
+		bool IsLeaf() const { return Children[0] == INDEX_NONE; }
+	};
+
+	static constexpr double MovableBoundsMargin = 10.0;
+
+	TArray<FEntry> Entries;
+
+	TMap<FObjectKey, int32> EntryIndices;
+
+	TArray<FNode> Nodes;
+
+	int32 Root = INDEX_NONE;
+
+	int32 FreeNode = INDEX_NONE;
+
+	int32 AllocateNode();
+
+	void ReleaseNode(const int32 NodeIndex);
+
+	void InsertLeaf(const int32 EntryIndex);
+
+	void RemoveLeaf(const int32 Leaf);
+
+	void RemoveEntry(const int32 EntryIndex);
+
+	void RefitAncestors(int32 NodeIndex);
+
+	static double GetSurfaceArea(const FBox& Bounds);
+
+	static FBox GetActorBounds(const AActor* Actor);
+
+	static bool IntersectRay(const FBox& Bounds,
+	                         const double Radius,
+	                         const FVector& Origin,
+	                         const FVector& InverseDirection,
+	                         const double MaxDistance,
+	                         double& OutDistance);
+};
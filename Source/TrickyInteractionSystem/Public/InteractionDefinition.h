@@ -0,0 +1,114 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "TrickyInteractionInterface.h"
+#include "InteractionDefinition.generated.h"
+
+/**
+ * Per-instance overrides for an interaction definition.
+ * Only the fields with enabled override flags are applied on top of the shared definition data.
+ * The object is instanced only for the actors which override something, other actors pay for a null pointer.
+ */
+UCLASS(BlueprintType, EditInlineNew, DefaultToInstanced, CollapseCategories)
+class TRICKYINTERACTIONSYSTEM_API UInteractionDataOverrides : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="InteractionData", meta=(InlineEditConditionToggle))
+	bool bOverrideInteractionMessage = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="InteractionData", meta=(InlineEditConditionToggle))
+	bool bOverrideRequiresLineOfSight = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="InteractionData", meta=(InlineEditConditionToggle))
+	bool bOverrideInteractionWeight = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="InteractionData", meta=(InlineEditConditionToggle))
+	bool bOverrideInteractionDuration = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="InteractionData", meta=(InlineEditConditionToggle))
+	bool bOverrideMaxInteractors = false;
+
+	UPROPERTY(EditAnywhere,
+		BlueprintReadWrite,
+		Category="InteractionData",
+		meta=(EditCondition="bOverrideInteractionMessage"))
+	FText InteractionMessage;
+
+	UPROPERTY(EditAnywhere,
+		BlueprintReadWrite,
+		Category="InteractionData",
+		meta=(EditCondition="bOverrideRequiresLineOfSight"))
+	bool bRequiresLineOfSight = false;
+
+	UPROPERTY(EditAnywhere,
+		BlueprintReadWrite,
+		Category="InteractionData",
+		meta=(EditCondition="bOverrideInteractionWeight", ClampMin=0, UIMin=0))
+	int32 InteractionWeight = 0;
+
+	UPROPERTY(EditAnywhere,
+		BlueprintReadWrite,
+		Category="InteractionData",
+		meta=(EditCondition="bOverrideInteractionDuration", ClampMin=0, UIMin=0, Units="s"))
+	float InteractionDuration = 0.f;
+
+	UPROPERTY(EditAnywhere,
+		BlueprintReadWrite,
+		Category="InteractionData",
+		meta=(EditCondition="bOverrideMaxInteractors", ClampMin=0, UIMin=0))
+	int32 MaxInteractors = 0;
+
+	bool HasAnyOverride() const
+	{
+		return bOverrideInteractionMessage
+			|| bOverrideRequiresLineOfSight
+			|| bOverrideInteractionWeight
+			|| bOverrideInteractionDuration
+			|| bOverrideMaxInteractors;
+	}
+
+	/**
+	 * Writes the overridden fields into the given interaction data
+	 */
+	void ApplyTo(FInteractionData& InteractionData) const;
+
+	/**
+	 * Returns the data of the definition with the overridden fields applied
+	 * The merged data is cached and merged again only if it doesn't match the definition and the overrides anymore,
+	 * so the fields can be changed at any time without invalidating the cache manually
+	 */
+	const FInteractionData& GetMergedData(const UInteractionDefinition* Definition) const;
+
+private:
+	/**
+	 * Compares every field of the cached data with its source, which is cheaper than merging and copying the message
+	 */
+	bool IsMergedDataCurrent(const FInteractionData& DefinitionData) const;
+
+	mutable TOptional<FInteractionData> MergedData;
+};
+
+/**
+ * Holds interaction data shared by many interactive actors.
+ * Reference it from an actor property named "InteractionDefinition" instead of declaring a per-instance InteractionData.
+ * Actors with a definition don't need the InteractionData property.
+ * Fields which differ per instance can be set in an optional instanced "InteractionOverrides" property.
+ */
+UCLASS(BlueprintType)
+class TRICKYINTERACTIONSYSTEM_API UInteractionDefinition : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintGetter, Category="InteractionDefinition")
+	const FInteractionData& GetInteractionData() const { return InteractionData; };
+
+private:
+	UPROPERTY(EditDefaultsOnly, BlueprintGetter=GetInteractionData, Category="InteractionDefinition")
+	FInteractionData InteractionData;
+};
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "InteractionQueueSnapshot.h"
+#include "InteractionViewPredictor.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "InteractionQueueComponent.generated.h"
 
@@ -13,6 +15,8 @@ namespace EDrawDebugTrace
 }
 
 class UCameraComponent;
+struct FStreamableHandle;
+class UTrickyInteractionSubsystem;
 struct FInteractionData;
 enum class EInteractionResult : uint8;
 
@@ -47,6 +51,120 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnInteractionForcedDynamicSignat
                                                AActor*, InteractiveActor,
                                                EInteractionResult, InteractionResult);
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnInteractionQueueHeadChangedDynamicSignature,
+                                               UInteractionQueueComponent*, Component,
+                                               AActor*, NewHead,
+                                               AActor*, PreviousHead);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnActorAddedToInteractionQueueSignature,
+                                     UInteractionQueueComponent*,
+                                     AActor*);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnActorRemovedFromInteractionQueueSignature,
+                                     UInteractionQueueComponent*,
+                                     AActor*);
+
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnInteractionStartedSignature,
+                                       UInteractionQueueComponent*,
+                                       AActor*,
+                                       EInteractionResult);
+
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnInteractionFinishedSignature,
+                                       UInteractionQueueComponent*,
+                                       AActor*,
+                                       EInteractionResult);
+
+DECLARE_MULTICAST_DELEGATE_FourParams(FOnInteractionInterruptedSignature,
+                                      UInteractionQueueComponent*,
+                                      AActor*,
+                                      AActor*,
+                                      EInteractionResult);
+
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnInteractionForcedSignature,
+                                       UInteractionQueueComponent*,
+                                       AActor*,
+                                       EInteractionResult);
+
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnInteractionQueueHeadChangedSignature,
+                                       UInteractionQueueComponent*,
+                                       AActor*,
+                                       AActor*);
+
+/**
+ * Defines how the line of sight target is picked
+ */
+UENUM(BlueprintType)
+enum class ELineOfSightBackend : uint8
+{
+	/** Sphere trace against the whole physics scene */
+	PhysicsSweep,
+	/** Ray query against the bounds of interactive actors only, confirmed by a single occlusion line trace */
+	InteractiveBounds
+};
+
+/**
+ * Compact record of a queue event stored while the event dispatch is deferred
+ */
+struct FInteractionQueueEvent
+{
+	enum class EType : uint8
+	{
+		ActorAdded,
+		ActorRemoved,
+		InteractionStarted,
+		InteractionFinished,
+		InteractionInterrupted,
+		InteractionForced
+	};
+
+	TWeakObjectPtr<AActor> InteractiveActor = nullptr;
+
+	TWeakObjectPtr<AActor> Interruptor = nullptr;
+
+	EType Type = EType::ActorAdded;
+
+	EInteractionResult InteractionResult{};
+};
+
+/**
+ * A public call of an interaction queue component with its arguments and its result
+ * Reported for every call, including the ones rejected by validation, throttling or the reject cache
+ */
+struct FInteractionQueueCall
+{
+	enum class EType : uint8
+	{
+		Add,
+		Remove,
+		AddBatch,
+		RemoveBatch,
+		Start,
+		StartTimed,
+		Finish,
+		Interrupt,
+		Force
+	};
+
+	EType Type = EType::Add;
+
+	/** The argument of Add and Remove, the interaction target at the time of Start, StartTimed and Force */
+	AActor* InteractiveActor = nullptr;
+
+	/** The argument of the batch calls */
+	TConstArrayView<AActor*> InteractiveActors;
+
+	AActor* Interruptor = nullptr;
+
+	float Duration = 0.f;
+
+	/** The returned bool of Add and Remove, the number of actors of the batch calls, EInteractionResult otherwise */
+	int32 Result = 0;
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnInteractionQueueCallSignature,
+                                     UInteractionQueueComponent*,
+                                     const FInteractionQueueCall&);
+
 UCLASS(ClassGroup=(TrickyInteractionSystem), meta=(BlueprintSpawnableComponent))
 class TRICKYINTERACTIONSYSTEM_API UInteractionQueueComponent : public UActorComponent
 {
@@ -58,11 +176,19 @@ public:
 protected:
 	virtual void InitializeComponent() override;
 
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
 	virtual void TickComponent(float DeltaTime,
 	                           ELevelTick TickType,
 	                           FActorComponentTickFunction* ThisTickFunction) override;
 
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
 	/**
 	 * Called when a new interactive actor is added to the interaction queue
 	 */
@@ -99,10 +225,42 @@ public:
 	UPROPERTY(BlueprintAssignable, Category="InteractionQueue")
 	FOnInteractionForcedDynamicSignature OnInteractionForced;
 
+	/**
+	 * Called when the first actor of the interaction queue changes
+	 */
+	UPROPERTY(BlueprintAssignable, Category="InteractionQueue")
+	FOnInteractionQueueHeadChangedDynamicSignature OnInteractionQueueHeadChanged;
+
+	/**
+	 * Native counterparts of the dynamic delegates above
+	 * They are broadcast before the dynamic ones and skip the reflection, use them for C++ listeners
+	 */
+	FOnActorAddedToInteractionQueueSignature OnActorAddedToInteractionQueueNative;
+
+	FOnActorRemovedFromInteractionQueueSignature OnActorRemovedFromInteractionQueueNative;
+
+	FOnInteractionStartedSignature OnInteractionStartedNative;
+
+	FOnInteractionFinishedSignature OnInteractionFinishedNative;
+
+	FOnInteractionInterruptedSignature OnInteractionInterruptedNative;
+
+	FOnInteractionForcedSignature OnInteractionForcedNative;
+
+	FOnInteractionQueueHeadChangedSignature OnInteractionQueueHeadChangedNative;
+
+	/**
+	 * Called after every call of the queue and interaction functions, e.g. to record them
+	 * Unlike the delegates above it's called immediately, also for the calls which didn't change anything.
+	 * The calls the component and the subsystem make on their own, e.g. finishing a timed interaction, aren't reported
+	 */
+	FOnInteractionQueueCallSignature OnInteractionQueueCallNative;
+
 	/**
 	 * Adds a new interactive actor to the interaction queue
+	 * Actors of a level which is being streamed in are added with one batch at the end of the frame
 	 * @param InteractiveActor An interactive actor to add. Must be a valid actor
-	 * @return True if the interactive actor was successfully added
+	 * @return True if the interactive actor was successfully added or its add was deferred
 	 */
 	UFUNCTION(BlueprintCallable, Category="InteractionQueue")
 	bool AddToInteractionQueue(AActor* InteractiveActor);
@@ -115,6 +273,22 @@ public:
 	UFUNCTION(BlueprintCallable, Category="InteractionQueue")
 	bool RemoveFromInteractionQueue(AActor* InteractiveActor);
 
+	/**
+	 * Adds several interactive actors to the interaction queue, sorting it once
+	 * @param InteractiveActors Interactive actors to add
+	 * @return Number of added actors
+	 */
+	UFUNCTION(BlueprintCallable, Category="InteractionQueue")
+	int32 AddToInteractionQueueBatch(const TArray<AActor*>& InteractiveActors);
+
+	/**
+	 * Removes several interactive actors from the interaction queue
+	 * @param InteractiveActors Interactive actors to remove. Can be already destroyed
+	 * @return Number of removed actors
+	 */
+	UFUNCTION(BlueprintCallable, Category="InteractionQueue")
+	int32 RemoveFromInteractionQueueBatch(const TArray<AActor*>& InteractiveActors);
+
 	/**
 	 * Checks if a given actor is in the interaction queue
 	 * @param Actor An interactive actor to check
@@ -123,37 +297,123 @@ public:
 	UFUNCTION(BlueprintCallable, Category="InteractionQueue")
 	bool IsInInteractionQueue(AActor* Actor);
 
-	UFUNCTION(BlueprintGetter, Category="InteractionQueue")
-	TArray<AActor*> GetInteractionQueue() const
+	/**
+	 * Returns a sorted copy of the interaction queue. C++ code should use GetInteractionQueueView instead
+	 */
+	UFUNCTION(BlueprintPure, Category="InteractionQueue")
+	TArray<AActor*> GetInteractionQueue() const;
+
+	/**
+	 * Returns the sorted interaction queue without copying it. Valid until the next queue mutation
+	 */
+	TConstArrayView<AActor*> GetInteractionQueueView() const;
+
+	/**
+	 * Copies the latest published snapshot of the queue. Can be called from any thread while the component is alive
+	 * The snapshot is published after every queue update and line of sight change on the game thread
+	 * @return False if the snapshot couldn't be read without tearing
+	 */
+	bool ReadInteractionQueueSnapshot(FInteractionQueueSnapshot& OutSnapshot) const
 	{
-		return InteractionQueue;
+		return SnapshotBuffer->Read(OutSnapshot);
 	};
 
+	/**
+	 * Returns the buffer the snapshots are published into
+	 * Systems on other threads can keep it to read snapshots without holding the component
+	 */
+	TSharedRef<const FInteractionQueueSnapshotBuffer, ESPMode::ThreadSafe> GetInteractionQueueSnapshotBuffer() const
+	{
+		return SnapshotBuffer;
+	};
+
+	/**
+	 * Returns the first actor in the interaction queue or nullptr if the queue is empty
+	 */
+	UFUNCTION(BlueprintPure, Category="InteractionQueue")
+	AActor* GetInteractionQueueHead() const;
+
+	/**
+	 * Returns the actor the last successful StartInteraction was called on, until it's finished or interrupted
+	 */
+	UFUNCTION(BlueprintPure, Category="InteractionQueue")
+	AActor* GetActiveInteractionActor() const { return ActiveInteractionActor; };
+
+	UFUNCTION(BlueprintGetter, Category="InteractionQueue")
+	bool GetDeferEventDispatch() const { return bDeferEventDispatch; };
+
 	UFUNCTION(BlueprintGetter, Category="InteractionQueue")
 	bool GetUseLineOfSight() const { return bUseLineOfSight; };
 
 	UFUNCTION(BlueprintSetter, Category="InteractionQueue")
 	void SetUseLineOfSight(bool Value);
 
+	ELineOfSightBackend GetLineOfSightBackend() const { return LineOfSightBackend; };
+
+	void SetLineOfSightBackend(const ELineOfSightBackend Value) { LineOfSightBackend = Value; };
+
+	/**
+	 * Applies the tick interval of the interaction scalability settings
+	 * Called on BeginPlay and when the TrickyInteraction console variables change
+	 */
+	void ApplyScalabilitySettings();
+
 	UFUNCTION(BlueprintPure, Category="InteractionQueue")
 	bool IsInteractionQueueEmpty() const { return InteractionQueue.IsEmpty(); };
 
 	/**
-	 * Starts interaction with the first actor in the interaction queue
-	 * @return result of the interaction start
+	 * Returns the first actor in the interaction queue which isn't fully reserved by other interactors
+	 * Start and Force interaction use this actor
+	 */
+	UFUNCTION(BlueprintPure, Category="InteractionQueue")
+	AActor* GetInteractionTarget() const;
+
+	/**
+	 * Starts interaction with the first actor in the interaction queue which isn't fully reserved
+	 * On success the actor is reserved until the interaction is finished or interrupted
+	 * @return result of the interaction start. Failure if all actors are fully reserved by other interactors
 	 */
 	UFUNCTION(BlueprintCallable, Category="InteractionQueue")
 	EInteractionResult StartInteraction();
 
 	/**
-	 * Starts interaction with the first actor in the interaction queue
+	 * Starts interaction with the first actor in the interaction queue and finishes it automatically after the duration
+	 * Overrides InteractionDuration of the actor's interaction data
+	 * @param Duration Duration of the interaction in seconds
+	 * @return result of the interaction start
+	 */
+	UFUNCTION(BlueprintCallable, Category="InteractionQueue")
+	EInteractionResult StartTimedInteraction(float Duration);
+
+	/**
+	 * Checks if a timed interaction is in progress
+	 */
+	UFUNCTION(BlueprintPure, Category="InteractionQueue")
+	bool IsTimedInteractionActive() const { return TimedInteractionHandle != 0; };
+
+	/**
+	 * Returns the progress of the current timed interaction in [0, 1] range. Computed on demand
+	 */
+	UFUNCTION(BlueprintPure, Category="InteractionQueue")
+	float GetTimedInteractionProgress() const;
+
+	/**
+	 * Returns the remaining time of the current timed interaction in seconds
+	 */
+	UFUNCTION(BlueprintPure, Category="InteractionQueue")
+	float GetTimedInteractionRemainingTime() const;
+
+	/**
+	 * Finishes the active interaction or, if no interaction was started, the interaction with the queue head
+	 * Returns Invalid and clears the active interaction if its actor became invalid
 	 * @return result of the interaction finish
 	 */
 	UFUNCTION(BlueprintCallable, Category="InteractionQueue")
 	EInteractionResult FinishInteraction();
 
 	/**
-	 * Interrupts current interaction sequence
+	 * Interrupts the active interaction or, if no interaction was started, the interaction with the queue head
+	 * Returns Invalid and clears the active interaction if its actor became invalid
 	 * @param Interruptor An actor which interrupts the interaction
 	 * @return result of the interaction interruption
 	 */
@@ -161,13 +421,42 @@ public:
 	EInteractionResult InterruptInteraction(AActor* Interruptor);
 
 	/**
-	 * Forces interaction with the first actor in the interaction queue
+	 * Forces interaction with the first actor in the interaction queue which isn't fully reserved
 	 * Usually used for immediate interactions which don't require animations
 	 * @return result of the interaction
 	 */
 	UFUNCTION(BlueprintCallable, Category="InteractionQueue")
 	EInteractionResult ForceInteraction();
 
+	/**
+	 * Forgets the rejected start and force requests, so the next request is fully validated
+	 * Call it when the state of an interactive actor changes and a repeated request may succeed
+	 */
+	UFUNCTION(BlueprintCallable, Category="InteractionQueue")
+	void ClearRejectedInteractionRequests();
+
+	/**
+	 * Writes the queue and the active interaction into a compact versioned binary form, e.g. for save games
+	 * Actors are stored with their sort weights by their persistent IDs or, if they were loaded with their level,
+	 * by their paths. Spawned actors without a persistent ID are skipped, see UTrickyInteractionSubsystem::SetPersistentActorId
+	 * @param OutData Saved state
+	 */
+	UFUNCTION(BlueprintCallable, Category="InteractionQueue")
+	void SaveInteractionState(TArray<uint8>& OutData) const;
+
+	/**
+	 * Replaces the queue and the active interaction with the saved state in one step
+	 * The queue isn't sorted unless the weights of the actors changed since saving. Actors which can't be found or
+	 * aren't interactive anymore are skipped. With bReconcileOverlapsOnRestore the queue is matched to the actors
+	 * overlapping the owner. The remove delegates are called for the dropped actors of the current queue,
+	 * the add delegates only for the overlapping actors which weren't saved. The active interaction is restored only
+	 * if its actor can be reserved again, otherwise the queue is restored without it.
+	 * @param Data State written by SaveInteractionState
+	 * @return False if the data is invalid or written by a newer version
+	 */
+	UFUNCTION(BlueprintCallable, Category="InteractionQueue")
+	bool RestoreInteractionState(const TArray<uint8>& Data);
+
 	/**
 	 * Registers a camera which will be used for the line of sight check
 	 * @param Camera Camera component to register
@@ -175,9 +464,107 @@ public:
 	UFUNCTION(BlueprintCallable, Category="InteractionQueue")
 	void RegisterCamera(UCameraComponent* Camera);
 
+	/**
+	 * Broadcasts the deferred events and sorts the queue if needed
+	 * Called by UTrickyInteractionSubsystem at the end of the frame
+	 */
+	void FlushPendingEvents();
+
+	/**
+	 * Finishes the timed interaction if the timer is still the current one
+	 * Called by UTrickyInteractionSubsystem when the timer expires
+	 */
+	void HandleTimedInteractionExpired(const uint32 TimerHandle);
+
+	/**
+	 * Drops the active interaction if its reservation timed out
+	 * Called by UTrickyInteractionSubsystem after the claim of the component was released
+	 */
+	void HandleReservationExpired(const AActor* InteractiveActor);
+
 private:
-	UPROPERTY(VisibleInstanceOnly, BlueprintGetter=GetInteractionQueue, Category="InteractionQueue")
-	TArray<AActor*> InteractionQueue;
+	static constexpr int32 InlineQueueCapacity = 8;
+
+	/**
+	 * Max movement and rotation of the view in radians for which a rejected request is rejected again
+	 */
+	static constexpr float RejectCacheViewLocationTolerance = 1.f;
+
+	static constexpr float RejectCacheViewAngleTolerance = UE_PI / 360.f;
+
+	/**
+	 * Most queues hold a few actors, so they are stored inline without heap allocations
+	 * Referenced in AddReferencedObjects, as reflection doesn't support inline allocators
+	 */
+	TArray<AActor*, TInlineAllocator<InlineQueueCapacity>> InteractionQueue;
+
+#if WITH_EDITORONLY_DATA
+	/**
+	 * Copy of InteractionQueue shown in the details panel, updated when a snapshot is published
+	 */
+	UPROPERTY(VisibleInstanceOnly, Transient, Category="InteractionQueue", meta=(DisplayName="Interaction Queue"))
+	TArray<TObjectPtr<AActor>> EditorInteractionQueue;
+#endif
+
+	/**
+	 * If true, the queue events are recorded and broadcast once at the end of the frame
+	 * Redundant add/remove pairs of the same actor cancel each other and the queue is sorted once per frame
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintGetter=GetDeferEventDispatch, Category="InteractionQueue")
+	bool bDeferEventDispatch = false;
+
+	/**
+	 * Time in seconds after which the reservation of an interactive actor is released
+	 * even if the interaction wasn't finished or interrupted. 0 disables the timeout
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="InteractionQueue", meta=(ClampMin=0, UIMin=0, Units="s"))
+	float ReservationTimeout = 0.f;
+
+	/**
+	 * If true, start and force interaction requests are rate limited and repeated rejected requests are
+	 * answered from a cache without validating them. Meant for the interactors of remote clients on the server
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="InteractionQueue|Throttling")
+	bool bThrottleInteractionRequests = false;
+
+	/**
+	 * Number of start and force requests per second restored to the token bucket of the interactor
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		Category="InteractionQueue|Throttling",
+		meta=(ClampMin=0, UIMin=0, EditCondition="bThrottleInteractionRequests"))
+	float InteractionRequestRate = 10.f;
+
+	/**
+	 * Max number of start and force requests which can be made at once
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		Category="InteractionQueue|Throttling",
+		meta=(ClampMin=1, UIMin=1, EditCondition="bThrottleInteractionRequests"))
+	int32 InteractionRequestBurst = 5;
+
+	/**
+	 * Time in seconds during which a rejected request is rejected again without validation
+	 * if the queue head and the actor in sight haven't changed. 0 disables the cache
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		Category="InteractionQueue|Throttling",
+		meta=(ClampMin=0, UIMin=0, Units="s", EditCondition="bThrottleInteractionRequests"))
+	float RejectCacheDuration = 0.25f;
+
+	/**
+	 * If true, InteractionAssets of the interaction data of the actors added to the queue are loaded asynchronously
+	 * The actors closer to the head of the queue are loaded with higher priority
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="InteractionQueue")
+	bool bPrefetchInteractionAssets = true;
+
+	/**
+	 * If true, RestoreInteractionState drops the saved actors which don't overlap the owner anymore and adds
+	 * the overlapping interactive actors which weren't saved. Disable it if the queue isn't filled by overlaps
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="InteractionQueue")
+	bool bReconcileOverlapsOnRestore = true;
 
 	/**
 	 * If true, the line of sight checks will be enabled if InteractionQueue isn't empty
@@ -197,6 +584,29 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category="InteractionQueue", meta=(EditCondition="bUseLineOfSight"))
 	TEnumAsByte<ETraceTypeQuery> TraceChannel = ETraceTypeQuery::TraceTypeQuery1;
 
+	/**
+	 * Defines how the line of sight target is picked.
+	 * InteractiveBounds is cheaper in levels with dense collision as only interactive actors are tested
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="InteractionQueue", meta=(EditCondition="bUseLineOfSight"))
+	ELineOfSightBackend LineOfSightBackend = ELineOfSightBackend::PhysicsSweep;
+
+	/**
+	 * If true, the line of sight is traced along the view predicted from the camera velocity for the next update
+	 * Start and force requests which disagree with the prediction are re-validated against the current view.
+	 * The component ticks every frame to sample the camera, the trace is still made once per tick interval
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="InteractionQueue", meta=(EditCondition="bUseLineOfSight"))
+	bool bPredictLineOfSight = false;
+
+	/**
+	 * Fraction of the tick interval the view is extrapolated by. 0.5 centers the prediction in the interval
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		Category="InteractionQueue",
+		meta=(ClampMin=0, ClampMax=1, UIMin=0, UIMax=1, EditCondition="bUseLineOfSight && bPredictLineOfSight"))
+	float LineOfSightPredictionFactor = 0.5f;
+
 	/**
 	 * Distance of the sphere trace which is used for line of sight checks
 	 */
@@ -239,11 +649,228 @@ private:
 	UPROPERTY()
 	TArray<AActor*> ActorsToIgnore;
 
+	/**
+	 * The head of the interaction queue which was reported by the last OnInteractionQueueHeadChanged call
+	 */
+	UPROPERTY(Transient)
+	AActor* InteractionQueueHead = nullptr;
+
+	UPROPERTY(Transient)
+	AActor* ActiveInteractionActor = nullptr;
+
+	/**
+	 * True from a successful StartInteraction until the interaction ends, even if its actor becomes invalid
+	 */
+	bool bHasActiveInteraction = false;
+
+	uint32 TimedInteractionHandle = 0;
+
+	double TimedInteractionStartTime = 0.0;
+
+	float TimedInteractionDuration = 0.f;
+
+	TArray<FInteractionQueueEvent> PendingEvents;
+
+	TArray<FInteractionQueueEvent> DispatchingEvents;
+
+	bool bIsSortPending = false;
+
+	/**
+	 * Number of line of sight ticks since the last sort, compared against TrickyInteraction.SortInterval
+	 */
+	int32 TicksSinceSort = 0;
+
+	bool bIsFlushRequested = false;
+
+	/**
+	 * Set when the queue is sorted or its head changes. Const accessors can complete a pending sort,
+	 * so the assets are requested again only on the mutating paths which publish the queue
+	 */
+	bool bIsAssetsPriorityUpdatePending = false;
+
+	struct FInteractionAssetsRequest
+	{
+		TSharedPtr<FStreamableHandle> Handle = nullptr;
+
+		/** Priority the handle was requested with, compared against the current queue position of the actor */
+		TAsyncLoadPriority Priority = 0;
+	};
+
+	TMap<TObjectKey<AActor>, FInteractionAssetsRequest> InteractionAssetRequests;
+
+	/**
+	 * The state in which a request was rejected and the result it was rejected with
+	 */
+	struct FRejectedRequest
+	{
+		TObjectKey<AActor> Head;
+
+		TObjectKey<AActor> ActorInSight;
+
+		/**
+		 * Current view of the camera when the request was rejected, only set with bPredictLineOfSight
+		 */
+		FVector ViewLocation = FVector::ZeroVector;
+
+		FQuat ViewRotation = FQuat::Identity;
+
+		double ExpirationTime = 0.0;
+
+		EInteractionResult Result;
+	};
+
+	FInteractionViewPredictor ViewPredictor;
+
+	float TimeSinceLineOfSightCheck = 0.f;
+
+	/**
+	 * True if the last line of sight trace was refused by the trace budget, the component ticks every frame until
+	 * it gets one
+	 */
+	bool bIsLineOfSightTraceStarved = false;
+
+	TOptional<FRejectedRequest> RejectedStartRequest;
+
+	TOptional<FRejectedRequest> RejectedForceRequest;
+
+	float RequestTokens = 0.f;
+
+	double RequestTokensUpdateTime = 0.0;
+
+	TSharedRef<FInteractionQueueSnapshotBuffer, ESPMode::ThreadSafe> SnapshotBuffer =
+		MakeShared<FInteractionQueueSnapshotBuffer, ESPMode::ThreadSafe>();
+
 	void SortInteractionQueue();
 
+	/**
+	 * Completes the sort deferred until the events flush, so the accessors never return the unsorted queue
+	 */
+	void SortInteractionQueueIfPending() const;
+
+	void SortInteractionQueueOnTick();
+
+	static int32 GetInteractionSortWeight(const AActor* Actor);
+
+	void UpdateInteractionQueueHead();
+
+	void BroadcastHeadChangeIfNeeded();
+
+	void PublishSnapshot();
+
+	bool AddToInteractionQueueInternal(AActor* InteractiveActor);
+
+	bool RemoveFromInteractionQueueInternal(AActor* InteractiveActor);
+
+	int32 AddToInteractionQueueBatchInternal(const TArray<AActor*>& InteractiveActors);
+
+	int32 RemoveFromInteractionQueueBatchInternal(const TArray<AActor*>& InteractiveActors);
+
+	EInteractionResult StartInteractionInternal(const float DurationOverride);
+
+	EInteractionResult FinishInteractionInternal();
+
+	EInteractionResult InterruptInteractionInternal(AActor* Interruptor);
+
+	EInteractionResult ForceInteractionInternal();
+
+	/**
+	 * Reports the start and force calls with the target they were made on, which is found only if anyone listens
+	 */
+	EInteractionResult ReportTargetedCall(FInteractionQueueCall& Call,
+	                                      const TFunctionRef<EInteractionResult()> CallFunction);
+
+	/**
+	 * Checks the reject cache and the token bucket before a start or force request is validated
+	 * @return True if the request must be rejected with OutResult
+	 */
+	bool ShouldRejectRequest(const TOptional<FRejectedRequest>& RejectedRequest, EInteractionResult& OutResult);
+
+	void CacheRequestResult(TOptional<FRejectedRequest>& RejectedRequest, const EInteractionResult Result);
+
+	/**
+	 * Checks if the camera still has the view the request was rejected in. Always true without the prediction
+	 */
+	bool IsRejectedRequestViewCurrent(const FRejectedRequest& RejectedRequest) const;
+
+	void StartTimedInteractionTimer(const float Duration);
+
+	void ClearActiveInteraction();
+
+	/**
+	 * Returns the actor of the started interaction, or the queue head if no interaction was started
+	 * Clears the active interaction and returns nullptr if its actor became invalid
+	 */
+	AActor* GetActiveInteractionTarget();
+
+	UTrickyInteractionSubsystem* GetInteractionSubsystem() const;
+
+	void RequestInteractionAssets(AActor* InteractiveActor);
+
+	void ReleaseInteractionAssets(AActor* InteractiveActor);
+
+	/**
+	 * The head of the queue is the most likely interaction target, so its assets are loaded first
+	 */
+	TAsyncLoadPriority GetInteractionAssetsPriority(const AActor* InteractiveActor) const;
+
+	/**
+	 * Requests the assets which are still loading again with the priority of the current queue position
+	 * Does nothing unless the queue was sorted or its head changed since the last update
+	 */
+	void UpdateInteractionAssetsPriorities();
+
+	/**
+	 * Events are deferred only if the world has the subsystem which flushes them, otherwise they're broadcast at once
+	 */
+	bool IsEventDispatchDeferred() const;
+
+	void RequestEventsFlush();
+
+	void DispatchEvent(const FInteractionQueueEvent& Event);
+
+	void BroadcastEvent(const FInteractionQueueEvent& Event);
+
+	void BroadcastActorAdded(AActor* InteractiveActor);
+
+	void BroadcastActorRemoved(AActor* InteractiveActor);
+
+	void BroadcastInteractionStarted(AActor* InteractiveActor, EInteractionResult InteractionResult);
+
+	void BroadcastInteractionFinished(AActor* InteractiveActor, EInteractionResult InteractionResult);
+
+	void BroadcastInteractionInterrupted(AActor* InteractiveActor,
+	                                     AActor* Interruptor,
+	                                     EInteractionResult InteractionResult);
+
+	void BroadcastInteractionForced(AActor* InteractiveActor, EInteractionResult InteractionResult);
+
+	void BroadcastHeadChanged(AActor* NewHead, AActor* PreviousHead);
+
 	void ToggleComponentTick();
 
-	void CheckLineOfSight(const float DeltaTime, FHitResult& OutHitResult) const;
+	/**
+	 * Returns the view used for the line of sight check, predicted if bPredictLineOfSight is true
+	 * @return False if there is no camera
+	 */
+	bool GetLineOfSightView(const float DeltaTime, FVector& OutLocation, FQuat& OutRotation) const;
+
+	/**
+	 * Adds the current camera view to the predictor
+	 */
+	void SampleLineOfSightView(const float DeltaTime);
+
+	void CheckLineOfSight(const FVector& ViewLocation, const FVector& ViewDirection, FHitResult& OutHitResult) const;
+
+	/**
+	 * Returns the view of the camera in this frame, without the prediction
+	 */
+	void GetCurrentLineOfSightView(FVector& OutLocation, FQuat& OutRotation) const;
+
+	/**
+	 * Checks if the actor is in sight, re-validating against the current view if the prediction disagrees
+	 * @param bOutIsOverTraceBudget True if the re-validation trace was refused by the trace budget
+	 */
+	bool IsInLineOfSight(AActor* InteractiveActor, bool& bOutIsOverTraceBudget);
 
 #if WITH_EDITOR && !UE_BUILD_SHIPPING
 	void PrintLog(const FString& Message);
@@ -0,0 +1,102 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include <atomic>
+
+/**
+ * Plain copy of the interaction queue state which can be read outside the game thread
+ * Actors are stored as keys, resolve them only on the game thread.
+ */
+struct FInteractionQueueSnapshot
+{
+	static constexpr int32 MaxQueueKeys = 8;
+
+	FObjectKey Head;
+
+	FObjectKey ActorInSight;
+
+	/** The first MaxQueueKeys actors of the sorted queue */
+	FObjectKey QueueKeys[MaxQueueKeys];
+
+	int32 QueueKeysNum = 0;
+
+	/** Number of actors in the queue, can be greater than QueueKeysNum */
+	int32 QueueNum = 0;
+
+	/** Value of GFrameCounter when the snapshot was published */
+	uint64 FrameNumber = 0;
+};
+
+/**
+ * Triple buffer of interaction queue snapshots with a single writer and any number of readers
+ * The game thread publishes into the slot after the latest one, so readers of the latest snapshot are only
+ * disturbed if two snapshots are published during a read. Each slot is guarded by a sequence counter,
+ * a torn read is detected and retried. Neither side takes locks or waits for the other.
+ */
+class FInteractionQueueSnapshotBuffer
+{
+public:
+	/**
+	 * Publishes a new snapshot. Must be called from one thread only
+	 */
+	void Publish(const FInteractionQueueSnapshot& Snapshot)
+	{
+		const uint32 Index = (LatestIndex.load(std::memory_order_relaxed) + 1) % SlotsNum;
+		FSlot& Slot = Slots[Index];
+		const uint32 Sequence = Slot.Sequence.load(std::memory_order_relaxed);
+
+		// An odd sequence marks the slot as being written
+		Slot.Sequence.store(Sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		Slot.Snapshot = Snapshot;
+		Slot.Sequence.store(Sequence + 2, std::memory_order_release);
+		LatestIndex.store(Index, std::memory_order_release);
+	}
+
+	/**
+	 * Copies the latest snapshot. Can be called from any thread
+	 * @return False if the writer kept overwriting the slot during all attempts, which needs several publishes per read
+	 */
+	bool Read(FInteractionQueueSnapshot& OutSnapshot) const
+	{
+		for (int32 Attempt = 0; Attempt < MaxReadAttempts; ++Attempt)
+		{
+			const FSlot& Slot = Slots[LatestIndex.load(std::memory_order_acquire)];
+			const uint32 Sequence = Slot.Sequence.load(std::memory_order_acquire);
+
+			if (Sequence & 1)
+			{
+				continue;
+			}
+
+			OutSnapshot = Slot.Snapshot;
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (Slot.Sequence.load(std::memory_order_relaxed) == Sequence)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+private:
+	static constexpr uint32 SlotsNum = 3;
+
+	static constexpr int32 MaxReadAttempts = 16;
+
+	struct alignas(PLATFORM_CACHE_LINE_SIZE) FSlot
+	{
+		std::atomic<uint32> Sequence = 0;
+
+		FInteractionQueueSnapshot Snapshot;
+	};
+
+	FSlot Slots[SlotsNum];
+
+	std::atomic<uint32> LatestIndex = 0;
+};
@@ -0,0 +1,238 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class UInteractionQueueComponent;
+class UTrickyInteractionSubsystem;
+struct FInteractionQueueCall;
+
+/**
+ * Types of the records stored in an interaction recording
+ * The event records are written only by the first version, which recorded the broadcast delegates.
+ * Later versions record the calls with their results, so rejected and throttled calls are replayed too.
+ */
+enum class EInteractionRecordType : uint8
+{
+	DefineActor,
+	DefineComponent,
+	ActorAdded,
+	ActorRemoved,
+	InteractionStarted,
+	InteractionFinished,
+	InteractionInterrupted,
+	InteractionForced,
+	QueueHeadChanged,
+	AddCall,
+	RemoveCall,
+	AddBatchCall,
+	RemoveBatchCall,
+	StartCall,
+	StartTimedCall,
+	FinishCall,
+	InterruptCall,
+	ForceCall,
+	Max
+};
+
+/**
+ * Encoding of the values stored in an interaction recording
+ * Unsigned integers are stored as little endian base 128 varints, names as a varint length followed by UTF-8 bytes.
+ */
+struct TRICKYINTERACTIONSYSTEM_API FInteractionRecordingFormat
+{
+	static void WriteVarint(TArray<uint8>& Buffer, uint64 Value);
+
+	/**
+	 * Reads a varint at the offset and advances the offset past it
+	 * @return False if the data ends before the varint or the varint is longer than 64 bits
+	 */
+	static bool ReadVarint(TConstArrayView<uint8> Data, int32& Offset, uint64& OutValue);
+
+	static void WriteName(TArray<uint8>& Buffer, const FName Name);
+
+	/**
+	 * Reads a name at the offset and advances the offset past it
+	 * @return False if the data ends before the name
+	 */
+	static bool ReadName(TConstArrayView<uint8> Data, int32& Offset, FName& OutName);
+
+	static void WriteFloat(TArray<uint8>& Buffer, const float Value);
+
+	/**
+	 * Reads a float at the offset and advances the offset past it
+	 * @return False if the data ends before the float
+	 */
+	static bool ReadFloat(TConstArrayView<uint8> Data, int32& Offset, float& OutValue);
+};
+
+/**
+ * Records the calls of all interaction queue components of a world into a compact binary file
+ * Every call is recorded with its arguments and result, also if it was rejected or its events were cancelled
+ * by the deferred dispatch. Every record starts with the varint encoded number of frames passed since
+ * the previous record.
+ * Actors and components are interned: their names are written once and referenced by varint ids afterwards.
+ */
+class TRICKYINTERACTIONSYSTEM_API FInteractionRecorder
+{
+public:
+	static constexpr uint32 FileMagic = 0x43524954;
+
+	static constexpr uint32 FileVersion = 2;
+
+	~FInteractionRecorder();
+
+	/**
+	 * Opens the file and binds to the queue components registered in the subsystem
+	 * @return True if the file was opened
+	 */
+	bool Start(UTrickyInteractionSubsystem* InSubsystem, const FString& Filename);
+
+	/**
+	 * Unbinds from the components and writes the rest of the records to the file
+	 */
+	void Stop();
+
+	bool IsRecording() const { return FileWriter.IsValid(); }
+
+	int32 GetRecordsNum() const { return RecordsNum; }
+
+	int64 GetBytesWritten() const { return BytesWritten + Buffer.Num(); }
+
+private:
+	static constexpr int32 FlushThreshold = 64 * 1024;
+
+	TUniquePtr<FArchive> FileWriter;
+
+	TWeakObjectPtr<UTrickyInteractionSubsystem> Subsystem = nullptr;
+
+	TArray<TWeakObjectPtr<UInteractionQueueComponent>> BoundComponents;
+
+	TMap<FObjectKey, uint32> ObjectIds;
+
+	TArray<uint8> Buffer;
+
+	uint64 LastFrame = 0;
+
+	int32 RecordsNum = 0;
+
+	int64 BytesWritten = 0;
+
+	FDelegateHandle ComponentRegisteredHandle;
+
+	void BindComponent(UTrickyInteractionSubsystem* InSubsystem, UInteractionQueueComponent* Component);
+
+	void HandleCall(UInteractionQueueComponent* Component, const FInteractionQueueCall& Call);
+
+	/**
+	 * Returns the id of the actor and writes its definition when it's seen for the first time. 0 for nullptr
+	 */
+	uint32 GetActorId(AActor* Actor);
+
+	uint32 GetComponentId(UInteractionQueueComponent* Component);
+
+	void BeginRecord(const EInteractionRecordType Type);
+
+	void FlushBuffer();
+};
+
+/**
+ * Drives the interaction queue components of a world with the call sequence stored in an interaction recording
+ * Actors and components are resolved by their names, so the recording must be replayed on the same map.
+ * The names of the actors are collected once when the replay starts and updated when actors are spawned.
+ * Results and interaction targets which differ from the recorded ones are counted as divergences.
+ */
+class TRICKYINTERACTIONSYSTEM_API FInteractionReplayer
+{
+public:
+	~FInteractionReplayer();
+
+	/**
+	 * Loads the recording
+	 * @return True if the file is a valid interaction recording
+	 */
+	bool Start(UWorld* InWorld, const FString& Filename);
+
+	void Stop();
+
+	/**
+	 * Applies the records which are due in the current frame
+	 * @return False when the recording is over
+	 */
+	bool Tick();
+
+	bool IsReplaying() const { return World.IsValid() && ReadOffset < Data.Num(); }
+
+	int32 GetRecordsNum() const { return RecordsNum; }
+
+	/**
+	 * Number of calls which returned a result different from the recorded one
+	 */
+	int32 GetDivergencesNum() const { return DivergencesNum; }
+
+	/**
+	 * Number of records which actors or components weren't found in the world
+	 */
+	int32 GetUnresolvedNum() const { return UnresolvedNum; }
+
+private:
+	struct FRecordedObject
+	{
+		FName Name = NAME_None;
+
+		/** Id of the owner for components, 0 for actors */
+		uint32 OwnerId = 0;
+
+		TWeakObjectPtr<UObject> Object = nullptr;
+	};
+
+	TWeakObjectPtr<UWorld> World = nullptr;
+
+	TArray<uint8> Data;
+
+	int32 ReadOffset = 0;
+
+	uint64 StartFrame = 0;
+
+	uint64 NextRecordFrame = 0;
+
+	bool bIsRecordFrameRead = false;
+
+	TArray<FRecordedObject> Objects;
+
+	TMap<FName, TWeakObjectPtr<AActor>> ActorsByName;
+
+	FDelegateHandle ActorSpawnedHandle;
+
+	int32 RecordsNum = 0;
+
+	int32 DivergencesNum = 0;
+
+	int32 UnresolvedNum = 0;
+
+	bool ApplyRecord(const EInteractionRecordType Type);
+
+	/**
+	 * Applies an event record of the first version, which is replayed as the call which caused the event
+	 */
+	bool ApplyEventRecord(const EInteractionRecordType Type, const uint32 ComponentId);
+
+	bool ApplyCallRecord(const EInteractionRecordType Type, const uint32 ComponentId);
+
+	/**
+	 * Counts a divergence if the result of the replayed call differs from the recorded one
+	 */
+	void CompareResult(const uint64 RecordedResult, const uint64 Result);
+
+	AActor* ResolveActor(const uint32 Id);
+
+	UInteractionQueueComponent* ResolveComponent(const uint32 Id);
+
+	void CacheActorNames();
+
+	void HandleActorSpawned(AActor* Actor);
+
+	bool ReadId(uint32& OutId);
+};
@@ -0,0 +1,97 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+
+/**
+ * Persistent identifier of an actor in a saved interaction state
+ * Actors with an ID set by UTrickyInteractionSubsystem::SetPersistentActorId are stored by the ID,
+ * actors loaded with their level by their path without the PIE prefix.
+ */
+struct TRICKYINTERACTIONSYSTEM_API FInteractionActorId
+{
+	FGuid Guid;
+
+	FSoftObjectPath Path;
+
+	bool IsValid() const { return Guid.IsValid() || Path.IsValid(); }
+
+	bool operator==(const FInteractionActorId& Other) const { return Guid == Other.Guid && Path == Other.Path; }
+
+	friend FArchive& operator<<(FArchive& Ar, FInteractionActorId& ActorId);
+};
+
+/**
+ * Saved state of an interaction queue component
+ * The entries keep the order of the sorted queue with the sort weights they had when saving.
+ */
+struct TRICKYINTERACTIONSYSTEM_API FInteractionQueueSavedState
+{
+	static constexpr uint32 Magic = 0x53515449;
+
+	/**
+	 * 1 stored the actors by their object paths, 2 by FInteractionActorId
+	 */
+	static constexpr uint32 Version = 2;
+
+	struct FEntry
+	{
+		FInteractionActorId ActorId;
+
+		int32 Weight = 0;
+	};
+
+	TArray<FEntry> Entries;
+
+	/**
+	 * Index of the active interaction actor in Entries
+	 */
+	int32 ActiveIndex = INDEX_NONE;
+
+	float TimedElapsedTime = 0.f;
+
+	float TimedDuration = 0.f;
+
+	void Write(TArray<uint8>& OutData) const;
+
+	/**
+	 * Reads the state written by this or an older version
+	 * @return False if the data is invalid or written by a newer version
+	 */
+	bool Read(const TArray<uint8>& Data);
+};
+
+/**
+ * Saved state of all interaction queue components of a world
+ * Components are stored by the ID of their owner and their name, their states are opaque blobs.
+ */
+struct TRICKYINTERACTIONSYSTEM_API FInteractionWorldSavedState
+{
+	static constexpr uint32 Magic = 0x53575449;
+
+	/**
+	 * 1 stored the components by their object paths, 2 by the owner ID and the component name
+	 */
+	static constexpr uint32 Version = 2;
+
+	struct FEntry
+	{
+		FInteractionActorId OwnerId;
+
+		FName ComponentName;
+
+		TArray<uint8> Data;
+	};
+
+	TArray<FEntry> Entries;
+
+	void Write(TArray<uint8>& OutData) const;
+
+	/**
+	 * Reads the state written by this or an older version
+	 * @return False if the data is invalid or written by a newer version
+	 */
+	bool Read(const TArray<uint8>& Data);
+};
@@ -0,0 +1,169 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Hashed timer wheel used by UTrickyInteractionSubsystem for timed interactions
+ * Timers are bucketed by their fire time, so advancing the wheel only visits the slots which passed since the last
+ * advance and the timers inside them. Timers scheduled further than one revolution stay in their slot until due.
+ */
+template <typename PayloadType>
+class TInteractionTimerWheel
+{
+public:
+	explicit TInteractionTimerWheel(const double InSlotDuration = 1.0 / 30.0, const int32 InSlotsNum = 256)
+		: SlotDuration(InSlotDuration),
+		  SlotsNum(InSlotsNum)
+	{
+		check(SlotDuration > 0.0 && SlotsNum > 0);
+		Slots.SetNum(SlotsNum);
+	}
+
+	/**
+	 * Schedules a new timer
+	 * @param FireTime Time in seconds when the timer expires
+	 * @param Payload Data returned when the timer expires
+	 * @return Handle of the timer, never 0
+	 */
+	uint32 Schedule(const double FireTime, const PayloadType& Payload)
+	{
+		if (++LastHandle == 0)
+		{
+			++LastHandle;
+		}
+
+		const int64 SlotTick = FMath::Max(GetSlotTick(FireTime), CurrentSlotTick);
+		const int32 SlotIndex = static_cast<int32>(SlotTick % SlotsNum);
+		Slots[SlotIndex].Add({LastHandle, FireTime, Payload});
+		HandleSlots.Add(LastHandle, SlotIndex);
+		return LastHandle;
+	}
+
+	/**
+	 * Cancels the timer
+	 * @return True if the timer was scheduled
+	 */
+	bool Cancel(const uint32 Handle)
+	{
+		int32 SlotIndex = INDEX_NONE;
+
+		if (!HandleSlots.RemoveAndCopyValue(Handle, SlotIndex))
+		{
+			return false;
+		}
+
+		TArray<FTimer>& Slot = Slots[SlotIndex];
+		const int32 TimerIndex = Slot.IndexOfByPredicate([Handle](const FTimer& Timer)
+		{
+			return Timer.Handle == Handle;
+		});
+
+		if (TimerIndex != INDEX_NONE)
+		{
+			Slot.RemoveAtSwap(TimerIndex, 1, EAllowShrinking::No);
+		}
+
+		return true;
+	}
+
+	bool IsScheduled(const uint32 Handle) const
+	{
+		return HandleSlots.Contains(Handle);
+	}
+
+	/**
+	 * Advances the wheel to the current time and collects the expired timers
+	 * Should be called every frame even if the wheel is empty, so it keeps up with the time while idle
+	 * @param CurrentTime Current time in seconds
+	 * @param OutExpired Handles and payloads of the expired timers
+	 */
+	void Advance(const double CurrentTime, TArray<TPair<uint32, PayloadType>>& OutExpired)
+	{
+		const int64 NewSlotTick = GetSlotTick(CurrentTime);
+
+		// An empty wheel jumps to the current slot, so the first advance after an idle period doesn't sweep every slot
+		if (HandleSlots.IsEmpty())
+		{
+			CurrentSlotTick = FMath::Max(CurrentSlotTick, NewSlotTick);
+			return;
+		}
+
+		const int64 SlotsToVisit = FMath::Min<int64>(NewSlotTick - CurrentSlotTick + 1, SlotsNum);
+
+		for (int64 i = 0; i < SlotsToVisit && !HandleSlots.IsEmpty(); ++i)
+		{
+			TArray<FTimer>& Slot = Slots[static_cast<int32>((CurrentSlotTick + i) % SlotsNum)];
+
+			for (int32 TimerIndex = Slot.Num() - 1; TimerIndex >= 0; --TimerIndex)
+			{
+				const FTimer& Timer = Slot[TimerIndex];
+
+				if (Timer.FireTime > CurrentTime)
+				{
+					continue;
+				}
+
+				HandleSlots.Remove(Timer.Handle);
+				OutExpired.Emplace(Timer.Handle, Timer.Payload);
+				Slot.RemoveAtSwap(TimerIndex, 1, EAllowShrinking::No);
+			}
+		}
+
+		// The current slot is visited again on the next advance as it may hold timers which aren't due yet
+		CurrentSlotTick = FMath::Max(CurrentSlotTick, NewSlotTick);
+	}
+
+	int32 Num() const
+	{
+		return HandleSlots.Num();
+	}
+
+	/**
+	 * Returns the slot tick the next advance starts from
+	 */
+	int64 GetCurrentSlotTick() const
+	{
+		return CurrentSlotTick;
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		SIZE_T AllocatedSize = Slots.GetAllocatedSize() + HandleSlots.GetAllocatedSize();
+
+		for (const TArray<FTimer>& Slot : Slots)
+		{
+			AllocatedSize += Slot.GetAllocatedSize();
+		}
+
+		return AllocatedSize;
+	}
+
+private:
+	struct FTimer
+	{
+		uint32 Handle = 0;
+
+		double FireTime = 0.0;
+
+		PayloadType Payload;
+	};
+
+	double SlotDuration = 1.0 / 30.0;
+
+	int32 SlotsNum = 256;
+
+	int64 CurrentSlotTick = 0;
+
+	uint32 LastHandle = 0;
+
+	TArray<TArray<FTimer>> Slots;
+
+	TMap<uint32, int32> HandleSlots;
+
+	int64 GetSlotTick(const double Time) const
+	{
+		return FMath::Max<int64>(FMath::FloorToInt64(Time / SlotDuration), 0);
+	}
+};
@@ -0,0 +1,55 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+/**
+ * Per frame budget of line of sight traces shared by the interaction queue components of a world
+ * A consumer refused a trace gets a reserved slot in the next frame, which consumers that weren't refused can't take,
+ * so the consumers which come first in the frame can't starve the others. A reservation which isn't claimed
+ * in the frame after the refusal expires, e.g. when the consumer stopped ticking.
+ */
+class TRICKYINTERACTIONSYSTEM_API FInteractionTraceBudget
+{
+public:
+	/**
+	 * Claims one trace of the frame
+	 * @param Consumer Key of the consumer which traces
+	 * @param Budget Max traces per frame, 0 or less is unlimited
+	 * @param Frame Number of the current frame
+	 * @return False if the budget of the frame is spent
+	 */
+	bool TryConsume(const FObjectKey Consumer, const int32 Budget, const uint64 Frame);
+
+	/**
+	 * Forgets the refusal of the consumer, e.g. when it's destroyed
+	 */
+	void Remove(const FObjectKey Consumer);
+
+	void Reset();
+
+	/**
+	 * Returns the number of slots of the current frame which are still reserved for refused consumers
+	 */
+	int32 GetReservedNum() const { return ReservedNum; }
+
+	int32 GetStarvedNum() const { return StarvedConsumers.Num(); }
+
+	SIZE_T GetAllocatedSize() const { return StarvedConsumers.GetAllocatedSize(); }
+
+private:
+	uint64 CurrentFrame = 0;
+
+	int32 UsedNum = 0;
+
+	int32 ReservedNum = 0;
+
+	/**
+	 * Consumers which were refused a trace and the last frame they were refused in
+	 */
+	TMap<FObjectKey, uint64> StarvedConsumers;
+
+	void BeginFrame(const int32 Budget, const uint64 Frame);
+};
@@ -0,0 +1,74 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Extrapolates the view of an interactor from its linear and angular velocity
+ * Used by UInteractionQueueComponent to trace the view it will most likely have until the next line of sight update.
+ * Only deceleration is extrapolated, so the prediction stops where a flick ends instead of overshooting it.
+ * Sample the view every frame, velocities measured over longer intervals miss short flicks.
+ */
+class TRICKYINTERACTIONSYSTEM_API FInteractionViewPredictor
+{
+public:
+	/**
+	 * Samples further apart than this are treated as a new motion and reset the velocities
+	 */
+	static constexpr float MaxSampleInterval = 0.5f;
+
+	/**
+	 * Max rotation of the predicted view. Limits overshooting when a flick stops
+	 */
+	static constexpr float MaxPredictedAngle = UE_HALF_PI * 0.5f;
+
+	/**
+	 * Adds a sample of the view and updates the velocities and accelerations
+	 * @param Location Location of the view
+	 * @param Rotation Rotation of the view
+	 * @param Time Time of the sample in seconds
+	 */
+	void AddSample(const FVector& Location, const FQuat& Rotation, const double Time);
+
+	/**
+	 * Extrapolates the last sample
+	 * @param LookAhead Time in seconds after the last sample
+	 * @param OutLocation Predicted location of the view
+	 * @param OutRotation Predicted rotation of the view
+	 */
+	void Predict(const float LookAhead, FVector& OutLocation, FQuat& OutRotation) const;
+
+	void Reset();
+
+	const FVector& GetLinearVelocity() const { return LinearVelocity; }
+
+	/**
+	 * Returns the angular velocity as the rotation axis scaled by radians per second
+	 */
+	const FVector& GetAngularVelocity() const { return AngularVelocity; }
+
+private:
+	FVector LastLocation = FVector::ZeroVector;
+
+	FQuat LastRotation = FQuat::Identity;
+
+	double LastTime = 0.0;
+
+	bool bHasSample = false;
+
+	FVector LinearVelocity = FVector::ZeroVector;
+
+	FVector AngularVelocity = FVector::ZeroVector;
+
+	FVector LinearAcceleration = FVector::ZeroVector;
+
+	FVector AngularAcceleration = FVector::ZeroVector;
+
+	bool bHasVelocity = false;
+
+	/**
+	 * Returns the distance travelled in the time with the velocity slowed down by the deceleration along it
+	 */
+	static FVector GetTravel(const FVector& Velocity, const FVector& Acceleration, const float Time);
+};
@@ -7,7 +7,7 @@
 #include "TrickyInteractionInterface.generated.h"
 
 USTRUCT(Blueprintable)
-struct FInteractionData
+struct TRICKYINTERACTIONSYSTEM_API FInteractionData
 {
 	GENERATED_BODY()
 
@@ -30,6 +30,27 @@ struct FInteractionData
 	 */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category="InteractionData", meta=(ClampMin=0, UIMin=0))
 	int32 InteractionWeight = 0;
+
+	/**
+	 * If greater than zero, a successful StartInteraction begins a timed interaction
+	 * which is finished automatically after this duration
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category="InteractionData", meta=(ClampMin=0, UIMin=0, Units="s"))
+	float InteractionDuration = 0.f;
+
+	/**
+	 * Maximum number of interactors which can interact with the actor at the same time
+	 * 0 means unlimited
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category="InteractionData", meta=(ClampMin=0, UIMin=0))
+	int32 MaxInteractors = 0;
+
+	/**
+	 * Assets used by the interaction, e.g. prompt icons, sounds and montages
+	 * They are loaded asynchronously when the actor is added to an interaction queue
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category="InteractionData")
+	TArray<TSoftObjectPtr<UObject>> InteractionAssets;
 };
 
 /**
@@ -44,7 +65,7 @@ enum class EInteractionResult : uint8
 };
 
 // This class does not need to be modified.
-UINTERFACE()
+UINTERFACE(MinimalAPI)
 class UTrickyInteractionInterface : public UInterface
 {
 	GENERATED_BODY()
@@ -9,6 +9,23 @@
 DECLARE_LOG_CATEGORY_EXTERN(LogTrickyInteractionSystem, Log, All)
 
 struct FInteractionData;
+class UInteractableComponent;
+class UInteractionDefinition;
+enum class EInteractionResult : uint8;
+
+/**
+ * Interaction properties of an actor class found by their names
+ * Null if the class doesn't have the property or its type doesn't match
+ */
+struct FInteractionDataProperties
+{
+	const FStructProperty* DataProperty = nullptr;
+
+	const FObjectProperty* DefinitionProperty = nullptr;
+
+	const FObjectProperty* OverridesProperty = nullptr;
+};
+
 /**
  * 
  */
@@ -25,18 +42,75 @@ public:
 	static bool GetActorInteractionData(AActor* Actor,
 	                                    FInteractionData& InteractionData);
 
+	/**
+	 * Finds the interaction data of an actor without copying it
+	 * Uses the interactable component of the actor first, then the shared InteractionDefinition
+	 * and falls back to the InteractionData property
+	 * The data of a definition with per-instance overrides is merged once and cached by the overrides object
+	 * @param Actor An interactive actor
+	 * @return Pointer to the interaction data or nullptr if the actor isn't interactive
+	 * Valid until the interaction data, the definition or the overrides of the actor change
+	 */
+	static const FInteractionData* FindActorInteractionData(const AActor* Actor);
+
+	/**
+	 * Returns the interaction properties of the class, looked up once per class and cached
+	 */
+	static const FInteractionDataProperties& FindInteractionDataProperties(const UClass* Class);
+
+	/**
+	 * Returns the shared InteractionDefinition of the actor or nullptr if it doesn't have one
+	 */
+	static const UInteractionDefinition* FindActorInteractionDefinition(const AActor* Actor);
+
+	/**
+	 * Returns the interactable component of the actor cached by UTrickyInteractionSubsystem
+	 * Falls back to searching the components of the actor if its world doesn't have the subsystem
+	 */
+	static UInteractableComponent* FindInteractableComponent(const AActor* Actor);
+
+	/**
+	 * Starts the interaction through the interactable component of the actor or its interaction interface
+	 * The Execute functions return Invalid if the actor has neither of them
+	 */
+	static EInteractionResult ExecuteStartInteraction(AActor* InteractiveActor, AActor* Interactor);
+
+	static EInteractionResult ExecuteInterruptInteraction(AActor* InteractiveActor, AActor* Interruptor, AActor* Interactor);
+
+	static EInteractionResult ExecuteFinishInteraction(AActor* InteractiveActor, AActor* Interactor);
+
+	static EInteractionResult ExecuteForceInteraction(AActor* InteractiveActor, AActor* Interactor);
+
 	UFUNCTION(BlueprintCallable, Category="TrickyInteraction", meta=(WorldContext="Actor"))
 	static bool AddToInteractionQueue(AActor* Interactor, AActor* InteractiveActor);
 
 	UFUNCTION(BlueprintCallable, Category="TrickyInteraction", meta=(WorldContext="Actor"))
 	static bool RemoveFromInteractionQueue(AActor* Interactor, AActor* InteractiveActor);
 
+	/**
+	 * Removes an interactive actor from every interaction queue which contains it
+	 * and interrupts all active interactions with it
+	 * @return Number of interaction queues the actor was removed from
+	 */
+	UFUNCTION(BlueprintCallable, Category="TrickyInteraction", meta=(WorldContext="Actor"))
+	static int32 RemoveFromAllInteractionQueues(AActor* InteractiveActor, AActor* Interruptor);
+
 	UFUNCTION(BlueprintCallable, Category="TrickyInteraction", meta=(WorldContext="Actor"))
 	static UInteractionQueueComponent* GetInteractionQueueComponent(const AActor* Actor);
 
 	UFUNCTION(BlueprintCallable, Category="TrickyInteraction", meta=(WorldContext="Actor"))
 	static bool IsInInteractionQueue(const AActor* Interactor, AActor* Actor);
 
+	/**
+	 * Applies the quality profile of the interaction system to all interaction queue components
+	 * @param Quality 0 Low, 1 Medium, 2 High, 3 Epic
+	 */
+	UFUNCTION(BlueprintCallable, Category="TrickyInteraction")
+	static void SetInteractionQuality(const int32 Quality);
+
+	UFUNCTION(BlueprintPure, Category="TrickyInteraction")
+	static int32 GetInteractionQuality();
+
 private:
 #if WITH_EDITOR && !UE_BUILD_SHIPPING
 	static void PrintWarning(const FString& Message);
@@ -0,0 +1,42 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Runtime settings of the interaction system controlled by console variables
+ * The quality profile sets all of them at once with the scalability priority, so the values set
+ * from the console or the ini files override the profile like the engine scalability groups do.
+ * Changes are applied to all playing interaction queue components.
+ *
+ * TrickyInteraction.Quality - 0 Low, 1 Medium, 2 High, 3 Epic
+ * TrickyInteraction.TickInterval - Interval of the line of sight ticks in seconds
+ * TrickyInteraction.TraceBudget - Max line of sight traces per frame and world. 0 is unlimited.
+ * Components over the budget get a reserved slot in the next frame
+ * TrickyInteraction.TraceDistanceScale, TrickyInteraction.TraceRadiusScale - Scale of the line of sight trace shape
+ * TrickyInteraction.SortInterval - Number of line of sight ticks between the queue sorts
+ */
+struct TRICKYINTERACTIONSYSTEM_API FInteractionScalability
+{
+	static constexpr int32 QualityLevelsNum = 4;
+
+	static int32 GetQuality();
+
+	/**
+	 * Applies the quality profile. The level is clamped to [0, QualityLevelsNum - 1]
+	 * The level is set with the console priority, so it replaces a level set from the console, the command line or
+	 * the ini files. Single variables set from the console or the ini files still override the profile.
+	 */
+	static void SetQuality(const int32 Quality);
+
+	static float GetTickInterval();
+
+	static int32 GetTraceBudget();
+
+	static float GetTraceDistanceScale();
+
+	static float GetTraceRadiusScale();
+
+	static int32 GetSortInterval();
+};
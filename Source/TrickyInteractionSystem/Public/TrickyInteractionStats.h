@@ -0,0 +1,48 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "HAL/PlatformTime.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("TrickyInteraction"), STATGROUP_TrickyInteraction, STATCAT_Advanced);
+
+/**
+ * Global counters of the interaction system which are reported by the stress commandlet
+ * Only updated on the game thread
+ */
+struct TRICKYINTERACTIONSYSTEM_API FInteractionPerfCounters
+{
+	/** Number of line of sight traces */
+	static int64 TracesNum;
+
+	/** Number of times the interaction queues and the pending event buffers grew their allocations */
+	static int64 ContainerAllocationsNum;
+
+	/** Time in seconds spent in the ticks of the interaction queue components and the interaction subsystem, including the event flush */
+	static double TickSeconds;
+
+	static void Reset()
+	{
+		TracesNum = 0;
+		ContainerAllocationsNum = 0;
+		TickSeconds = 0.0;
+	}
+
+	/** Adds the time spent in its scope to TickSeconds */
+	struct FTickTimeScope
+	{
+		FTickTimeScope()
+			: StartTime(FPlatformTime::Seconds())
+		{
+		}
+
+		~FTickTimeScope()
+		{
+			TickSeconds += FPlatformTime::Seconds() - StartTime;
+		}
+
+	private:
+		double StartTime = 0.0;
+	};
+};
@@ -0,0 +1,457 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InteractionBoundsHierarchy.h"
+#include "InteractionRecording.h"
+#include "InteractionSavedState.h"
+#include "InteractionTimerWheel.h"
+#include "InteractionTraceBudget.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TrickyInteractionSubsystem.generated.h"
+
+class UInteractableComponent;
+class UInteractionQueueComponent;
+class UTrickyInteractionSubsystem;
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnInteractiveActorsRegisteredSignature,
+                                     UTrickyInteractionSubsystem*,
+                                     TConstArrayView<AActor*>);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnInteractiveActorsUnregisteredSignature,
+                                     UTrickyInteractionSubsystem*,
+                                     TConstArrayView<AActor*>);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnQueueComponentRegisteredSignature,
+                                     UTrickyInteractionSubsystem*,
+                                     UInteractionQueueComponent*);
+
+/**
+ * Owns the world-level state of the interaction system
+ */
+UCLASS()
+class TRICKYINTERACTIONSYSTEM_API UTrickyInteractionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
+	/**
+	 * Called with a batch of interactive actors registered from a loaded level or spawned at runtime
+	 */
+	FOnInteractiveActorsRegisteredSignature OnInteractiveActorsRegistered;
+
+	/**
+	 * Called with a batch of interactive actors unregistered because their level was unloaded
+	 */
+	FOnInteractiveActorsUnregisteredSignature OnInteractiveActorsUnregistered;
+
+	/**
+	 * Called when an interaction queue component begins play in the world
+	 */
+	FOnQueueComponentRegisteredSignature OnQueueComponentRegistered;
+
+	/**
+	 * Registers the interaction queue component which began play. Called by UInteractionQueueComponent
+	 */
+	void RegisterQueueComponent(UInteractionQueueComponent* Component);
+
+	/**
+	 * Unregisters the interaction queue component which ended play. Called by UInteractionQueueComponent
+	 */
+	void UnregisterQueueComponent(UInteractionQueueComponent* Component);
+
+	/**
+	 * Returns all interaction queue components which are playing in the world
+	 */
+	void GetQueueComponents(TArray<UInteractionQueueComponent*>& OutComponents) const;
+
+	/**
+	 * Caches the interactable component for its owner. Called by UInteractableComponent
+	 */
+	void RegisterInteractableComponent(UInteractableComponent* Component);
+
+	/**
+	 * Removes the interactable component from the cache. Called by UInteractableComponent
+	 * If the owner has another registered interactable component, it's cached instead
+	 */
+	void UnregisterInteractableComponent(const UInteractableComponent* Component);
+
+	/**
+	 * Returns the cached interactable component of the actor or nullptr
+	 */
+	UInteractableComponent* FindInteractableComponent(const AActor* Actor) const;
+
+	/**
+	 * Schedules the deferred events of the component to be flushed at the end of the current frame
+	 * @param Component Interaction queue component with pending events
+	 */
+	void RequestEventsFlush(UInteractionQueueComponent* Component);
+
+	/**
+	 * Records that the interactive actor was added to the interaction queue of the component
+	 * Called by UInteractionQueueComponent
+	 */
+	void RegisterQueueEntry(AActor* InteractiveActor, UInteractionQueueComponent* Component);
+
+	/**
+	 * Records that the interactive actor was removed from the interaction queue of the component
+	 * Called by UInteractionQueueComponent
+	 */
+	void UnregisterQueueEntry(AActor* InteractiveActor, UInteractionQueueComponent* Component);
+
+	/**
+	 * Defers adding an actor of a level which is being streamed in to the interaction queue of the component
+	 * The overlaps of a streamed level arrive one actor at a time, so the deferred actors are added
+	 * at the end of the subsystem tick with one AddToInteractionQueueBatch call per component
+	 * @return True if the add was deferred
+	 */
+	bool TryDeferQueueAdd(AActor* InteractiveActor, UInteractionQueueComponent* Component);
+
+	/**
+	 * Cancels a deferred add, e.g. if the actor stopped overlapping the interactor before it was added
+	 * @return True if the add was deferred and is cancelled
+	 */
+	bool CancelDeferredQueueAdd(const AActor* InteractiveActor, const UInteractionQueueComponent* Component);
+
+	/**
+	 * True while the deferred adds are applied. The adds were already reported when they were deferred
+	 */
+	bool IsProcessingDeferredQueueAdds() const { return bIsProcessingDeferredQueueAdds; };
+
+	/**
+	 * Returns all interaction queue components which have the given actor in their queues
+	 * @param InteractiveActor An interactive actor to check
+	 * @param OutComponents Components holding the actor
+	 */
+	UFUNCTION(BlueprintCallable, Category="TrickyInteraction")
+	void GetInteractionQueueHolders(AActor* InteractiveActor, TArray<UInteractionQueueComponent*>& OutComponents) const;
+
+	/**
+	 * Removes the actor from all interaction queues and interrupts every active interaction with it
+	 * @param InteractiveActor An interactive actor to remove. Can be already destroyed
+	 * @param Interruptor An actor which interrupts the active interactions
+	 * @return Number of interaction queues the actor was removed from
+	 */
+	UFUNCTION(BlueprintCallable, Category="TrickyInteraction")
+	int32 RemoveFromAllInteractionQueues(AActor* InteractiveActor, AActor* Interruptor);
+
+	/**
+	 * Removes the actors from all interaction queues, sorting every affected queue at most once
+	 * @param InteractiveActors Interactive actors to remove. Can be already destroyed
+	 * @param Interruptor An actor which interrupts the active interactions
+	 * @return Number of removed queue entries
+	 */
+	UFUNCTION(BlueprintCallable, Category="TrickyInteraction")
+	int32 RemoveFromAllInteractionQueuesBatch(const TArray<AActor*>& InteractiveActors, AActor* Interruptor);
+
+	/**
+	 * Checks if the actor was registered as an interactive actor of this world
+	 */
+	UFUNCTION(BlueprintPure, Category="TrickyInteraction")
+	bool IsInteractiveActorRegistered(AActor* Actor) const;
+
+	/**
+	 * Checks if the interactive actors of the level are still being registered
+	 */
+	UFUNCTION(BlueprintPure, Category="TrickyInteraction")
+	bool IsLevelRegistrationPending(const ULevel* Level) const;
+
+	/**
+	 * Schedules finishing of a timed interaction on the timer wheel
+	 * @param Component Interaction queue component which started the interaction
+	 * @param Duration Duration of the interaction in seconds
+	 * @return Handle of the timer, 0 if it wasn't scheduled
+	 */
+	uint32 ScheduleTimedInteraction(UInteractionQueueComponent* Component, const float Duration);
+
+	/**
+	 * Cancels a scheduled timed interaction
+	 */
+	void CancelTimedInteraction(const uint32 Handle);
+
+	/**
+	 * Returns the number of timed interactions in progress
+	 */
+	UFUNCTION(BlueprintPure, Category="TrickyInteraction")
+	int32 GetTimedInteractionsNum() const { return TimedInteractionsWheel.Num(); };
+
+	/**
+	 * Finds the closest registered interactive actor which bounds are hit by a sphere moving along the ray
+	 * Only the bounds of interactive actors are tested, the result isn't checked for occlusion
+	 * @param Start Start of the ray
+	 * @param End End of the ray
+	 * @param Radius Radius of the sphere
+	 * @param ActorsToIgnore Actors which are skipped
+	 * @param OutHitLocation Point where the ray enters the bounds of the found actor
+	 * @return The closest interactive actor or nullptr
+	 */
+	AActor* RaycastInteractiveBounds(const FVector& Start,
+	                                 const FVector& End,
+	                                 const float Radius,
+	                                 TConstArrayView<AActor*> ActorsToIgnore,
+	                                 FVector& OutHitLocation);
+
+	/**
+	 * Claims one line of sight trace from the per frame budget defined by TrickyInteraction.TraceBudget
+	 * Components which were refused get a slot reserved in the next frame, so a component can't be starved by
+	 * the components which tick before it. The reservation expires if the component doesn't trace in that frame.
+	 * @param Component Interaction queue component which traces
+	 * @return False if the budget of the current frame is spent
+	 */
+	bool TryConsumeTraceBudget(const UInteractionQueueComponent* Component);
+
+	/**
+	 * Claims a slot of the interactive actor for the component
+	 * The capacity of the actor is defined by MaxInteractors of its interaction data and is read on every claim
+	 * @param InteractiveActor An interactive actor to reserve
+	 * @param Component Interaction queue component which claims the actor
+	 * @param Timeout Time in seconds after which the claim is released and the component drops the active interaction.
+	 * 0 disables the timeout
+	 * @return True if the actor had a free slot or the component has already claimed it
+	 */
+	bool TryReserveInteraction(AActor* InteractiveActor, UInteractionQueueComponent* Component, const float Timeout);
+
+	/**
+	 * Releases the claim of the component on the interactive actor
+	 */
+	void ReleaseInteraction(AActor* InteractiveActor, const UInteractionQueueComponent* Component);
+
+	/**
+	 * Checks if all slots of the interactive actor are claimed by other components
+	 * @param InteractiveActor An interactive actor to check
+	 * @param Component Interaction queue component which claim is ignored
+	 * @return True if the component can't claim the actor
+	 */
+	UFUNCTION(BlueprintPure, Category="TrickyInteraction")
+	bool IsInteractionFullyReserved(AActor* InteractiveActor, const UInteractionQueueComponent* Component) const;
+
+	/**
+	 * Returns the number of components which claimed the interactive actor
+	 */
+	UFUNCTION(BlueprintPure, Category="TrickyInteraction")
+	int32 GetInteractionReservationsNum(AActor* InteractiveActor) const;
+
+	/**
+	 * Returns the streamable manager used to prefetch interaction assets of the world
+	 */
+	FStreamableManager& GetStreamableManager() { return StreamableManager; }
+
+	/**
+	 * Starts recording the events of all interaction queue components into a binary file
+	 * @param Filename Path of the recording
+	 * @return True if the recording started
+	 */
+	bool StartRecording(const FString& Filename);
+
+	/**
+	 * Stops the recording and writes the rest of it to the file
+	 */
+	void StopRecording();
+
+	bool IsRecording() const { return Recorder.IsValid() && Recorder->IsRecording(); }
+
+	/**
+	 * Starts replaying the recording. The records are applied frame by frame by the subsystem tick
+	 * @param Filename Path of the recording
+	 * @return True if the recording was loaded
+	 */
+	bool StartReplay(const FString& Filename);
+
+	void StopReplay();
+
+	bool IsReplaying() const { return Replayer.IsValid() && Replayer->IsReplaying(); }
+
+	/**
+	 * Writes the interaction state of all interaction queue components of the world
+	 * Components are stored by the ID of their owner and their name, components of owners without an ID are skipped
+	 * @param OutData Saved state
+	 */
+	UFUNCTION(BlueprintCallable, Category="TrickyInteraction")
+	void SaveInteractionState(TArray<uint8>& OutData) const;
+
+	/**
+	 * Restores the interaction state of all saved interaction queue components in one step
+	 * @param Data State written by SaveInteractionState
+	 * @return Number of restored components, INDEX_NONE if the data is invalid
+	 */
+	UFUNCTION(BlueprintCallable, Category="TrickyInteraction")
+	int32 RestoreInteractionState(const TArray<uint8>& Data);
+
+	/**
+	 * Sets the ID which identifies the actor in saved interaction states
+	 * Actors spawned at runtime need it to be saved, set the same ID on the respawned actor before restoring.
+	 * The ID is forgotten when the actor is destroyed.
+	 * @param Actor Actor to identify
+	 * @param Id Unique ID, an invalid ID clears the ID of the actor
+	 */
+	UFUNCTION(BlueprintCallable, Category="TrickyInteraction")
+	void SetPersistentActorId(AActor* Actor, const FGuid& Id);
+
+	/**
+	 * @return The ID set by SetPersistentActorId or an invalid ID
+	 */
+	UFUNCTION(BlueprintPure, Category="TrickyInteraction")
+	FGuid GetPersistentActorId(const AActor* Actor) const;
+
+	/**
+	 * Makes the saved ID of the actor from its persistent ID or, if it was loaded with its level, from its path
+	 * @return An invalid ID if the actor can't be found after loading
+	 */
+	FInteractionActorId MakeActorId(const AActor* Actor) const;
+
+	/**
+	 * Finds the actor of the saved ID in this world
+	 */
+	AActor* ResolveActorId(const FInteractionActorId& ActorId) const;
+
+private:
+	struct FInteractionClaim
+	{
+		TWeakObjectPtr<UInteractionQueueComponent> Component = nullptr;
+
+		uint32 TimeoutHandle = 0;
+	};
+
+	struct FInteractionReservation
+	{
+		TArray<FInteractionClaim, TInlineAllocator<2>> Claims;
+	};
+
+	struct FReservationTimeout
+	{
+		TObjectKey<AActor> InteractiveActor;
+
+		TWeakObjectPtr<UInteractionQueueComponent> Component = nullptr;
+	};
+
+	/**
+	 * Claims of the interactive actors with limited capacity
+	 */
+	TMap<TObjectKey<AActor>, FInteractionReservation> Reservations;
+
+	TInteractionTimerWheel<FReservationTimeout> ReservationTimeoutsWheel;
+
+	TArray<TPair<uint32, FReservationTimeout>> ExpiredReservations;
+
+	/**
+	 * Returns MaxInteractors of the interactive actor, 0 if its capacity is unlimited
+	 */
+	static int32 GetReservationCapacity(AActor* InteractiveActor);
+
+	void RemoveReservation(const AActor* InteractiveActor);
+
+	struct FPendingLevelRegistration
+	{
+		TWeakObjectPtr<ULevel> Level = nullptr;
+
+		int32 NextActorIndex = 0;
+	};
+
+	/**
+	 * Interactive actors of the loaded levels and the actors spawned at runtime
+	 */
+	TSet<TWeakObjectPtr<AActor>> RegisteredActors;
+
+	/**
+	 * Levels which interactive actors are registered over several frames within the time budget
+	 */
+	TArray<FPendingLevelRegistration> PendingLevelRegistrations;
+
+	/**
+	 * Actors of streamed levels waiting to be added to the interaction queues of the components
+	 */
+	TMap<TWeakObjectPtr<UInteractionQueueComponent>, TArray<TWeakObjectPtr<AActor>>> DeferredQueueAdds;
+
+	bool bIsProcessingDeferredQueueAdds = false;
+
+	/**
+	 * Bounds of the registered interactive actors used for line of sight picking
+	 */
+	FInteractionBoundsHierarchy InteractiveBounds;
+
+	uint64 InteractiveBoundsUpdateFrame = 0;
+
+	FInteractionTraceBudget TraceBudget;
+
+	/**
+	 * IDs set by SetPersistentActorId and the reverse lookup
+	 */
+	TMap<TObjectKey<AActor>, FGuid> PersistentActorIds;
+
+	TMap<FGuid, TWeakObjectPtr<AActor>> PersistentIdActors;
+
+	TInteractionTimerWheel<TWeakObjectPtr<UInteractionQueueComponent>> TimedInteractionsWheel;
+
+	FStreamableManager StreamableManager;
+
+	/**
+	 * Interaction queue components which are playing in the world
+	 */
+	TArray<TWeakObjectPtr<UInteractionQueueComponent>> QueueComponents;
+
+	/**
+	 * Interactable components of the actors, so they are found without iterating the components of the actor
+	 */
+	TMap<TObjectKey<AActor>, TWeakObjectPtr<UInteractableComponent>> InteractableComponents;
+
+	TUniquePtr<FInteractionRecorder> Recorder;
+
+	TUniquePtr<FInteractionReplayer> Replayer;
+
+	TArray<TPair<uint32, TWeakObjectPtr<UInteractionQueueComponent>>> ExpiredTimedInteractions;
+
+	FDelegateHandle LevelAddedHandle;
+
+	FDelegateHandle LevelRemovedHandle;
+
+	FDelegateHandle ActorSpawnedHandle;
+
+	FDelegateHandle ActorDestroyedHandle;
+
+	using FQueueHolders = TArray<TWeakObjectPtr<UInteractionQueueComponent>, TInlineAllocator<2>>;
+
+	/**
+	 * Reverse index from interactive actors to the queue components which contain them
+	 */
+	TMap<TObjectKey<AActor>, FQueueHolders> QueueHolders;
+
+	TArray<TWeakObjectPtr<UInteractionQueueComponent>> PendingFlushComponents;
+
+	TArray<TWeakObjectPtr<UInteractionQueueComponent>> FlushingComponents;
+
+	FDelegateHandle PostActorTickHandle;
+
+	void HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaTime);
+
+	void HandleLevelAddedToWorld(ULevel* Level, UWorld* World);
+
+	void HandleLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+
+	void HandleActorSpawned(AActor* Actor);
+
+	void HandleActorDestroyed(AActor* Actor);
+
+	void ProcessPendingLevelRegistrations();
+
+	void ProcessDeferredQueueAdds();
+
+	void ProcessExpiredTimedInteractions();
+
+	void ProcessExpiredReservations();
+
+	void ProcessReplay();
+};
@@ -0,0 +1,436 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractionStressCommandlet.h"
+
+#include "InteractionQueueComponent.h"
+#include "InteractionStressInteractor.h"
+#include "InteractionStressMalloc.h"
+#include "InteractionStressTarget.h"
+#include "TrickyInteractionStats.h"
+#include "Components/SphereComponent.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonSerializer.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogInteractionStress, Log, All);
+
+namespace
+{
+	/**
+	 * How the interaction queues are filled
+	 * Batch - the commandlet finds the nearby actors itself and updates every queue with one batch call per frame
+	 * Overlap - the sphere of every interactor adds and removes the actors in its overlap handlers
+	 */
+	enum class EInteractionStressQueueMode : uint8
+	{
+		Batch,
+		Overlap
+	};
+
+	struct FInteractionStressSettings
+	{
+		int32 InteractorsNum = 10;
+
+		int32 TargetsPerInteractor = 4;
+
+		int32 FramesNum = 600;
+
+		int32 WarmupFramesNum = 60;
+
+		int32 Seed = 1337;
+
+		ELineOfSightBackend Backend = ELineOfSightBackend::PhysicsSweep;
+
+		EInteractionStressQueueMode QueueMode = EInteractionStressQueueMode::Batch;
+	};
+
+	struct FStressInteractor
+	{
+		AInteractionStressInteractor* Actor = nullptr;
+
+		UInteractionQueueComponent* InteractionQueue = nullptr;
+
+		FVector Velocity = FVector::ZeroVector;
+
+		float YawRate = 0.f;
+	};
+
+	constexpr float StressDeltaTime = 1.f / 60.f;
+
+	/** Interactive actors closer than this distance are added to the interaction queue */
+	constexpr float QueueRadius = 400.f;
+
+	constexpr float TargetSpacing = 300.f;
+
+	/** Each interactor starts or finishes an interaction once per this number of frames */
+	constexpr int32 InteractionPeriod = 30;
+
+	FIntPoint GetCell(const FVector& Location)
+	{
+		return FIntPoint(FMath::FloorToInt(Location.X / QueueRadius), FMath::FloorToInt(Location.Y / QueueRadius));
+	}
+
+	double GetPercentile(const TArray<double>& SortedValues, const double Percentile)
+	{
+		if (SortedValues.IsEmpty())
+		{
+			return 0.0;
+		}
+
+		const int32 Index = FMath::CeilToInt(Percentile * SortedValues.Num()) - 1;
+		return SortedValues[FMath::Clamp(Index, 0, SortedValues.Num() - 1)];
+	}
+
+	/** Sorts the frame times in milliseconds and reports their percentiles, maximum and mean */
+	TSharedRef<FJsonObject> MakeTimesObject(TArray<double>& Times)
+	{
+		Times.Sort();
+		double TotalTime = 0.0;
+
+		for (const double Time : Times)
+		{
+			TotalTime += Time;
+		}
+
+		TSharedRef<FJsonObject> TimesObject = MakeShared<FJsonObject>();
+		TimesObject->SetNumberField(TEXT("P50"), GetPercentile(Times, 0.5));
+		TimesObject->SetNumberField(TEXT("P95"), GetPercentile(Times, 0.95));
+		TimesObject->SetNumberField(TEXT("P99"), GetPercentile(Times, 0.99));
+		TimesObject->SetNumberField(TEXT("Max"), Times.IsEmpty() ? 0.0 : Times.Last());
+		TimesObject->SetNumberField(TEXT("Mean"), TotalTime / FMath::Max(Times.Num(), 1));
+		return TimesObject;
+	}
+
+	/**
+	 * Finds the targets within QueueRadius in the neighbouring cells and updates the queue with two batch calls
+	 * Finding the targets stands in for the game's overlap detection, so only the batch calls are measured and counted
+	 * @return Time in seconds spent in the batch calls
+	 */
+	double UpdateQueueInBatches(const FStressInteractor& Interactor,
+	                            const FVector& Location,
+	                            const TMap<FIntPoint, TArray<AActor*>>& TargetCells,
+	                            TArray<AActor*>& NearbyTargets,
+	                            TArray<AActor*>& FarTargets)
+	{
+		NearbyTargets.Reset();
+		FarTargets.Reset();
+		const FIntPoint Cell = GetCell(Location);
+
+		for (int32 X = -1; X <= 1; ++X)
+		{
+			for (int32 Y = -1; Y <= 1; ++Y)
+			{
+				const TArray<AActor*>* Targets = TargetCells.Find(Cell + FIntPoint(X, Y));
+
+				if (!Targets)
+				{
+					continue;
+				}
+
+				for (AActor* Target : *Targets)
+				{
+					if (FVector::DistSquared2D(Target->GetActorLocation(), Location) <= FMath::Square(QueueRadius))
+					{
+						NearbyTargets.Add(Target);
+					}
+				}
+			}
+		}
+
+		for (AActor* QueuedActor : Interactor.InteractionQueue->GetInteractionQueueView())
+		{
+			if (!NearbyTargets.Contains(QueuedActor))
+			{
+				FarTargets.Add(QueuedActor);
+			}
+		}
+
+		const FInteractionStressMalloc::FCountingScope CountingScope;
+		const double StartTime = FPlatformTime::Seconds();
+		Interactor.InteractionQueue->RemoveFromInteractionQueueBatch(FarTargets);
+		Interactor.InteractionQueue->AddToInteractionQueueBatch(NearbyTargets);
+		return FPlatformTime::Seconds() - StartTime;
+	}
+
+	UWorld* CreateStressWorld()
+	{
+		UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("InteractionStress"));
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+		World->bShouldSimulatePhysics = true;
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+
+		// The world has no game mode which would dispatch BeginPlay to the actors
+		if (!World->HasBegunPlay())
+		{
+			World->GetWorldSettings()->NotifyBeginPlay();
+		}
+
+		return World;
+	}
+
+	void DestroyStressWorld(UWorld* World)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	TSharedRef<FJsonObject> RunStressScenario(const FInteractionStressSettings& Settings)
+	{
+		UWorld* World = CreateStressWorld();
+		FRandomStream Random(Settings.Seed);
+
+		const int32 TargetsNum = Settings.InteractorsNum * Settings.TargetsPerInteractor;
+		const int32 GridSize = FMath::Max(FMath::CeilToInt(FMath::Sqrt(static_cast<float>(TargetsNum))), 1);
+		const float AreaSize = GridSize * TargetSpacing;
+		TMap<FIntPoint, TArray<AActor*>> TargetCells;
+
+		for (int32 i = 0; i < TargetsNum; ++i)
+		{
+			const FVector Location((i % GridSize + 0.5f) * TargetSpacing, (i / GridSize + 0.5f) * TargetSpacing, 0.f);
+			AInteractionStressTarget* Target = World->SpawnActor<AInteractionStressTarget>(Location, FRotator::ZeroRotator);
+
+			if (!Target)
+			{
+				continue;
+			}
+
+			Target->InteractionData.bRequiresLineOfSight = Random.FRand() < 0.5f;
+			Target->InteractionData.InteractionWeight = Random.RandRange(0, 10);
+			TargetCells.FindOrAdd(GetCell(Location)).Add(Target);
+		}
+
+		TArray<FStressInteractor> Interactors;
+		Interactors.Reserve(Settings.InteractorsNum);
+
+		for (int32 i = 0; i < Settings.InteractorsNum; ++i)
+		{
+			const FVector Location(Random.FRandRange(0.f, AreaSize), Random.FRandRange(0.f, AreaSize), 0.f);
+			const FRotator Rotation(0.f, Random.FRandRange(0.f, 360.f), 0.f);
+			AInteractionStressInteractor* Actor = World->SpawnActor<AInteractionStressInteractor>(Location, Rotation);
+
+			if (!Actor)
+			{
+				continue;
+			}
+
+			Actor->OverlapComponent->SetSphereRadius(QueueRadius);
+			Actor->SetUseOverlaps(Settings.QueueMode == EInteractionStressQueueMode::Overlap);
+
+			FStressInteractor& Interactor = Interactors.AddDefaulted_GetRef();
+			Interactor.Actor = Actor;
+			Interactor.InteractionQueue = Actor->InteractionQueue;
+			Interactor.InteractionQueue->SetLineOfSightBackend(Settings.Backend);
+			Interactor.InteractionQueue->SetUseLineOfSight(true);
+			Interactor.Velocity = FVector(Random.FRandRange(-1.f, 1.f), Random.FRandRange(-1.f, 1.f), 0.f).GetSafeNormal()
+				* Random.FRandRange(100.f, 400.f);
+			Interactor.YawRate = Random.FRandRange(-90.f, 90.f);
+		}
+
+		TArray<double> InteractionTimes;
+		InteractionTimes.Reserve(Settings.FramesNum);
+		TArray<double> WorldTickTimes;
+		WorldTickTimes.Reserve(Settings.FramesNum);
+		TArray<AActor*> NearbyTargets;
+		TArray<AActor*> FarTargets;
+		int64 InteractionsNum = 0;
+
+		for (int32 Frame = 0; Frame < Settings.WarmupFramesNum + Settings.FramesNum; ++Frame)
+		{
+			if (Frame == Settings.WarmupFramesNum)
+			{
+				FInteractionPerfCounters::Reset();
+				FInteractionStressMalloc::ResetAllocationsNum();
+				FInteractionStressMalloc::Install();
+				InteractionsNum = 0;
+			}
+
+			const bool bIsMeasuredFrame = Frame >= Settings.WarmupFramesNum;
+
+			// The calls of the stress loop, the overlap handlers and the ticks of the queues and the subsystem
+			double InteractionTime = 0.0;
+
+			for (int32 i = 0; i < Interactors.Num(); ++i)
+			{
+				FStressInteractor& Interactor = Interactors[i];
+				FVector Location = Interactor.Actor->GetActorLocation() + Interactor.Velocity * StressDeltaTime;
+
+				for (int32 Axis = 0; Axis < 2; ++Axis)
+				{
+					if (Location[Axis] < 0.f || Location[Axis] > AreaSize)
+					{
+						Interactor.Velocity[Axis] = -Interactor.Velocity[Axis];
+						Location[Axis] = FMath::Clamp<double>(Location[Axis], 0.0, AreaSize);
+					}
+				}
+
+				FRotator Rotation = Interactor.Actor->GetActorRotation();
+				Rotation.Yaw += Interactor.YawRate * StressDeltaTime;
+
+				// In the overlap mode the move calls the overlap handlers, only the handlers are measured
+				Interactor.Actor->SetActorLocationAndRotation(Location, Rotation);
+				InteractionTime += Interactor.Actor->ConsumeOverlapHandlersTime();
+
+				if (Settings.QueueMode == EInteractionStressQueueMode::Batch)
+				{
+					InteractionTime += UpdateQueueInBatches(Interactor, Location, TargetCells, NearbyTargets, FarTargets);
+				}
+
+				const FInteractionStressMalloc::FCountingScope CountingScope;
+				const double StartTime = FPlatformTime::Seconds();
+
+				if ((Frame + i) % InteractionPeriod == 0)
+				{
+					if (Interactor.InteractionQueue->GetActiveInteractionActor())
+					{
+						Interactor.InteractionQueue->FinishInteraction();
+					}
+					else if (Interactor.InteractionQueue->StartInteraction() == EInteractionResult::Success)
+					{
+						++InteractionsNum;
+					}
+				}
+
+				InteractionTime += FPlatformTime::Seconds() - StartTime;
+			}
+
+			// The world tick also contains the engine work, only the interaction ticks inside it are added
+			const double TickSecondsBefore = FInteractionPerfCounters::TickSeconds;
+			const double TickStartTime = FPlatformTime::Seconds();
+
+			{
+				const FInteractionStressMalloc::FCountingScope CountingScope;
+				World->Tick(LEVELTICK_All, StressDeltaTime);
+			}
+
+			const double WorldTickTime = FPlatformTime::Seconds() - TickStartTime;
+			InteractionTime += FInteractionPerfCounters::TickSeconds - TickSecondsBefore;
+			++GFrameCounter;
+
+			if (bIsMeasuredFrame)
+			{
+				InteractionTimes.Add(InteractionTime * 1000.0);
+				WorldTickTimes.Add(WorldTickTime * 1000.0);
+			}
+		}
+
+		FInteractionStressMalloc::Uninstall();
+
+		const int32 MeasuredFramesNum = FMath::Max(InteractionTimes.Num(), 1);
+
+		TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+		Result->SetNumberField(TEXT("Interactors"), Interactors.Num());
+		Result->SetNumberField(TEXT("Targets"), TargetsNum);
+		Result->SetNumberField(TEXT("Frames"), InteractionTimes.Num());
+		Result->SetNumberField(TEXT("Seed"), Settings.Seed);
+		Result->SetStringField(TEXT("Backend"),
+		                       StaticEnum<ELineOfSightBackend>()->GetNameStringByValue(
+			                       static_cast<int64>(Settings.Backend)));
+		Result->SetStringField(TEXT("QueueMode"),
+		                       Settings.QueueMode == EInteractionStressQueueMode::Overlap ? TEXT("Overlap") : TEXT("Batch"));
+		Result->SetObjectField(TEXT("InteractionMs"), MakeTimesObject(InteractionTimes));
+		Result->SetObjectField(TEXT("WorldTickMs"), MakeTimesObject(WorldTickTimes));
+		Result->SetNumberField(TEXT("Traces"), static_cast<double>(FInteractionPerfCounters::TracesNum));
+		Result->SetNumberField(TEXT("TracesPerFrame"),
+		                       static_cast<double>(FInteractionPerfCounters::TracesNum) / MeasuredFramesNum);
+		Result->SetNumberField(TEXT("Allocations"), static_cast<double>(FInteractionStressMalloc::GetAllocationsNum()));
+		Result->SetNumberField(TEXT("AllocationsPerFrame"),
+		                       static_cast<double>(FInteractionStressMalloc::GetAllocationsNum()) / MeasuredFramesNum);
+		Result->SetNumberField(TEXT("ContainerAllocations"),
+		                       static_cast<double>(FInteractionPerfCounters::ContainerAllocationsNum));
+		Result->SetNumberField(TEXT("InteractionsStarted"), static_cast<double>(InteractionsNum));
+
+		DestroyStressWorld(World);
+		return Result;
+	}
+}
+
+UInteractionStressCommandlet::UInteractionStressCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = true;
+	LogToConsole = true;
+}
+
+int32 UInteractionStressCommandlet::Main(const FString& Params)
+{
+	FInteractionStressSettings Settings;
+	FString InteractorsList = TEXT("10,100,1000");
+	FString BackendName;
+	FString OutputPath;
+
+	FParse::Value(*Params, TEXT("Interactors="), InteractorsList, false);
+	FParse::Value(*Params, TEXT("TargetsPerInteractor="), Settings.TargetsPerInteractor);
+	FParse::Value(*Params, TEXT("Frames="), Settings.FramesNum);
+	FParse::Value(*Params, TEXT("Warmup="), Settings.WarmupFramesNum);
+	FParse::Value(*Params, TEXT("Seed="), Settings.Seed);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	FString QueueModeName;
+
+	if (FParse::Value(*Params, TEXT("QueueMode="), QueueModeName))
+	{
+		if (QueueModeName.Equals(TEXT("Overlap")))
+		{
+			Settings.QueueMode = EInteractionStressQueueMode::Overlap;
+		}
+		else if (!QueueModeName.Equals(TEXT("Batch")))
+		{
+			UE_LOG(LogInteractionStress, Error, TEXT("Unknown queue mode %s"), *QueueModeName);
+			return 1;
+		}
+	}
+
+	if (FParse::Value(*Params, TEXT("Backend="), BackendName))
+	{
+		const int64 Backend = StaticEnum<ELineOfSightBackend>()->GetValueByNameString(BackendName);
+
+		if (Backend == INDEX_NONE)
+		{
+			UE_LOG(LogInteractionStress, Error, TEXT("Unknown line of sight backend %s"), *BackendName);
+			return 1;
+		}
+
+		Settings.Backend = static_cast<ELineOfSightBackend>(Backend);
+	}
+
+	Settings.TargetsPerInteractor = FMath::Max(Settings.TargetsPerInteractor, 0);
+	Settings.FramesNum = FMath::Max(Settings.FramesNum, 1);
+	Settings.WarmupFramesNum = FMath::Max(Settings.WarmupFramesNum, 0);
+
+	TArray<FString> InteractorsNums;
+	InteractorsList.ParseIntoArray(InteractorsNums, TEXT(","));
+	TArray<TSharedPtr<FJsonValue>> Runs;
+
+	for (const FString& InteractorsNum : InteractorsNums)
+	{
+		Settings.InteractorsNum = FMath::Max(FCString::Atoi(*InteractorsNum), 1);
+		UE_LOG(LogInteractionStress, Display, TEXT("Running interaction stress test with %d interactors"),
+		       Settings.InteractorsNum);
+		Runs.Add(MakeShared<FJsonValueObject>(RunStressScenario(Settings)));
+	}
+
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetArrayField(TEXT("Runs"), Runs);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Report, Writer);
+	UE_LOG(LogInteractionStress, Display, TEXT("%s"), *Json);
+
+	if (!OutputPath.IsEmpty() && !FFileHelper::SaveStringToFile(Json, *OutputPath))
+	{
+		UE_LOG(LogInteractionStress, Error, TEXT("Failed to write the stress report to %s"), *OutputPath);
+		return 1;
+	}
+
+	return 0;
+}
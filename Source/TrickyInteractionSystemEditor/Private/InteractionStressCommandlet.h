@@ -0,0 +1,27 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "InteractionStressCommandlet.generated.h"
+
+/**
+ * Headless scaling test of the interaction system
+ * Spawns interactors with line of sight interaction queues and interactive actors in an empty world, moves the
+ * interactors with a seeded deterministic pattern and reports frame cost percentiles, trace and allocation counts as JSON.
+ * Allocations are counted by a proxy of GMalloc on the game thread during the measured parts of the frames.
+ *
+ * Usage: -run=InteractionStress [-Interactors=10,100,1000] [-TargetsPerInteractor=4] [-Frames=600] [-Warmup=60]
+ *        [-Seed=1337] [-Backend=PhysicsSweep|InteractiveBounds] [-QueueMode=Batch|Overlap] [-Output=Path.json]
+ */
+UCLASS()
+class UInteractionStressCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UInteractionStressCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
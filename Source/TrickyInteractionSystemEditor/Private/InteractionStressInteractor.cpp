@@ -0,0 +1,74 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractionStressInteractor.h"
+
+#include "InteractionQueueComponent.h"
+#include "InteractionStressMalloc.h"
+#include "Camera/CameraComponent.h"
+#include "Components/SphereComponent.h"
+#include "Engine/CollisionProfile.h"
+
+AInteractionStressInteractor::AInteractionStressInteractor()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	OverlapComponent = CreateDefaultSubobject<USphereComponent>(TEXT("OverlapComponent"));
+	OverlapComponent->InitSphereRadius(400.f);
+	OverlapComponent->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	OverlapComponent->SetGenerateOverlapEvents(false);
+	SetRootComponent(OverlapComponent);
+
+	CameraComponent = CreateDefaultSubobject<UCameraComponent>(TEXT("CameraComponent"));
+	CameraComponent->SetupAttachment(OverlapComponent);
+
+	InteractionQueue = CreateDefaultSubobject<UInteractionQueueComponent>(TEXT("InteractionQueue"));
+}
+
+void AInteractionStressInteractor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	OverlapComponent->OnComponentBeginOverlap.AddDynamic(this, &AInteractionStressInteractor::HandleBeginOverlap);
+	OverlapComponent->OnComponentEndOverlap.AddDynamic(this, &AInteractionStressInteractor::HandleEndOverlap);
+	InteractionQueue->RegisterCamera(CameraComponent);
+}
+
+void AInteractionStressInteractor::SetUseOverlaps(const bool bValue)
+{
+	OverlapComponent->SetGenerateOverlapEvents(bValue);
+	OverlapComponent->SetCollisionProfileName(bValue
+		                                          ? FName(TEXT("OverlapAllDynamic"))
+		                                          : UCollisionProfile::NoCollision_ProfileName);
+}
+
+double AInteractionStressInteractor::ConsumeOverlapHandlersTime()
+{
+	const double Time = OverlapHandlersTime;
+	OverlapHandlersTime = 0.0;
+	return Time;
+}
+
+void AInteractionStressInteractor::HandleBeginOverlap(UPrimitiveComponent* OverlappedComponent,
+                                                      AActor* OtherActor,
+                                                      UPrimitiveComponent* OtherComp,
+                                                      int32 OtherBodyIndex,
+                                                      bool bFromSweep,
+                                                      const FHitResult& SweepResult)
+{
+	FInteractionStressMalloc::FCountingScope CountingScope;
+	const double StartTime = FPlatformTime::Seconds();
+	InteractionQueue->AddToInteractionQueue(OtherActor);
+	OverlapHandlersTime += FPlatformTime::Seconds() - StartTime;
+}
+
+void AInteractionStressInteractor::HandleEndOverlap(UPrimitiveComponent* OverlappedComponent,
+                                                    AActor* OtherActor,
+                                                    UPrimitiveComponent* OtherComp,
+                                                    int32 OtherBodyIndex)
+{
+	FInteractionStressMalloc::FCountingScope CountingScope;
+	const double StartTime = FPlatformTime::Seconds();
+	InteractionQueue->RemoveFromInteractionQueue(OtherActor);
+	OverlapHandlersTime += FPlatformTime::Seconds() - StartTime;
+}
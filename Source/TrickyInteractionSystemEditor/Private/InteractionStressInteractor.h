@@ -0,0 +1,62 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "InteractionStressInteractor.generated.h"
+
+class UCameraComponent;
+class UInteractionQueueComponent;
+class USphereComponent;
+
+/**
+ * Interactor spawned by the stress commandlet
+ * In the overlap mode its sphere adds the overlapped actors to the interaction queue like a game interactor would.
+ */
+UCLASS(NotPlaceable, Transient)
+class AInteractionStressInteractor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AInteractionStressInteractor();
+
+	virtual void BeginPlay() override;
+
+	/**
+	 * Enables the overlap events of the sphere. If disabled, the commandlet fills the queue in batches
+	 */
+	void SetUseOverlaps(const bool bValue);
+
+	/**
+	 * Returns the time in seconds spent in the overlap handlers since the previous call
+	 */
+	double ConsumeOverlapHandlersTime();
+
+	UPROPERTY(VisibleAnywhere, Category="InteractionStress")
+	TObjectPtr<USphereComponent> OverlapComponent = nullptr;
+
+	UPROPERTY(VisibleAnywhere, Category="InteractionStress")
+	TObjectPtr<UCameraComponent> CameraComponent = nullptr;
+
+	UPROPERTY(VisibleAnywhere, Category="InteractionStress")
+	TObjectPtr<UInteractionQueueComponent> InteractionQueue = nullptr;
+
+private:
+	double OverlapHandlersTime = 0.0;
+
+	UFUNCTION()
+	void HandleBeginOverlap(UPrimitiveComponent* OverlappedComponent,
+	                        AActor* OtherActor,
+	                        UPrimitiveComponent* OtherComp,
+	                        int32 OtherBodyIndex,
+	                        bool bFromSweep,
+	                        const FHitResult& SweepResult);
+
+	UFUNCTION()
+	void HandleEndOverlap(UPrimitiveComponent* OverlappedComponent,
+	                      AActor* OtherActor,
+	                      UPrimitiveComponent* OtherComp,
+	                      int32 OtherBodyIndex);
+};
@@ -0,0 +1,149 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractionStressMalloc.h"
+
+void FInteractionStressMalloc::Install()
+{
+	FInteractionStressMalloc& Proxy = Get();
+
+	if (GMalloc == Proxy.InnerMalloc)
+	{
+		GMalloc = &Proxy;
+	}
+}
+
+void FInteractionStressMalloc::Uninstall()
+{
+	FInteractionStressMalloc& Proxy = Get();
+
+	if (GMalloc == &Proxy)
+	{
+		GMalloc = Proxy.InnerMalloc;
+	}
+}
+
+int64 FInteractionStressMalloc::GetAllocationsNum()
+{
+	return Get().AllocationsNum;
+}
+
+void FInteractionStressMalloc::ResetAllocationsNum()
+{
+	Get().AllocationsNum = 0;
+}
+
+FInteractionStressMalloc::FCountingScope::FCountingScope()
+{
+	++Get().CountingScopesNum;
+}
+
+FInteractionStressMalloc::FCountingScope::~FCountingScope()
+{
+	--Get().CountingScopesNum;
+}
+
+void* FInteractionStressMalloc::Malloc(SIZE_T Count, uint32 Alignment)
+{
+	CountAllocation();
+	return InnerMalloc->Malloc(Count, Alignment);
+}
+
+void* FInteractionStressMalloc::TryMalloc(SIZE_T Count, uint32 Alignment)
+{
+	CountAllocation();
+	return InnerMalloc->TryMalloc(Count, Alignment);
+}
+
+void* FInteractionStressMalloc::Realloc(void* Original, SIZE_T Count, uint32 Alignment)
+{
+	CountAllocation();
+	return InnerMalloc->Realloc(Original, Count, Alignment);
+}
+
+void* FInteractionStressMalloc::TryRealloc(void* Original, SIZE_T Count, uint32 Alignment)
+{
+	CountAllocation();
+	return InnerMalloc->TryRealloc(Original, Count, Alignment);
+}
+
+void FInteractionStressMalloc::Free(void* Original)
+{
+	InnerMalloc->Free(Original);
+}
+
+SIZE_T FInteractionStressMalloc::QuantizeSize(SIZE_T Count, uint32 Alignment)
+{
+	return InnerMalloc->QuantizeSize(Count, Alignment);
+}
+
+bool FInteractionStressMalloc::GetAllocationSize(void* Original, SIZE_T& SizeOut)
+{
+	return InnerMalloc->GetAllocationSize(Original, SizeOut);
+}
+
+void FInteractionStressMalloc::Trim(bool bTrimThreadCaches)
+{
+	InnerMalloc->Trim(bTrimThreadCaches);
+}
+
+void FInteractionStressMalloc::SetupTLSCachesOnCurrentThread()
+{
+	InnerMalloc->SetupTLSCachesOnCurrentThread();
+}
+
+void FInteractionStressMalloc::ClearAndDisableTLSCachesOnCurrentThread()
+{
+	InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+}
+
+void FInteractionStressMalloc::UpdateStats()
+{
+	InnerMalloc->UpdateStats();
+}
+
+void FInteractionStressMalloc::GetAllocatorStats(FGenericMemoryStats& OutStats)
+{
+	InnerMalloc->GetAllocatorStats(OutStats);
+}
+
+void FInteractionStressMalloc::DumpAllocatorStats(FOutputDevice& Ar)
+{
+	InnerMalloc->DumpAllocatorStats(Ar);
+}
+
+bool FInteractionStressMalloc::ValidateHeap()
+{
+	return InnerMalloc->ValidateHeap();
+}
+
+bool FInteractionStressMalloc::IsInternallyThreadSafe() const
+{
+	return InnerMalloc->IsInternallyThreadSafe();
+}
+
+const TCHAR* FInteractionStressMalloc::GetDescriptiveName()
+{
+	return InnerMalloc->GetDescriptiveName();
+}
+
+FInteractionStressMalloc::FInteractionStressMalloc(FMalloc* InInnerMalloc)
+	: InnerMalloc(InInnerMalloc)
+{
+}
+
+FInteractionStressMalloc& FInteractionStressMalloc::Get()
+{
+	// Allocated with the system allocator of FMalloc and intentionally leaked
+	static FInteractionStressMalloc* Proxy = new FInteractionStressMalloc(GMalloc);
+	return *Proxy;
+}
+
+void FInteractionStressMalloc::CountAllocation()
+{
+	// The game thread is checked first, so other threads never read the counters
+	if (IsInGameThread() && CountingScopesNum > 0)
+	{
+		++AllocationsNum;
+	}
+}
@@ -0,0 +1,82 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+
+/**
+ * Allocator proxy which counts the allocations of the game thread while the stress commandlet measures a frame
+ * It's installed into GMalloc only for the measured frames. The proxy is never destroyed, as other threads can still
+ * call it after the original allocator is restored.
+ */
+class FInteractionStressMalloc final : public FMalloc
+{
+public:
+	/**
+	 * Wraps GMalloc with the proxy. Does nothing if GMalloc was replaced by another allocator after the first call
+	 */
+	static void Install();
+
+	static void Uninstall();
+
+	static int64 GetAllocationsNum();
+
+	static void ResetAllocationsNum();
+
+	/**
+	 * Allocations of the game thread are counted while at least one scope is alive
+	 */
+	struct FCountingScope
+	{
+		FCountingScope();
+
+		~FCountingScope();
+	};
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override;
+
+	virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override;
+
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override;
+
+	virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override;
+
+	virtual void Free(void* Original) override;
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override;
+
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override;
+
+	virtual void Trim(bool bTrimThreadCaches) override;
+
+	virtual void SetupTLSCachesOnCurrentThread() override;
+
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override;
+
+	virtual void UpdateStats() override;
+
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override;
+
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override;
+
+	virtual bool ValidateHeap() override;
+
+	virtual bool IsInternallyThreadSafe() const override;
+
+	virtual const TCHAR* GetDescriptiveName() override;
+
+private:
+	explicit FInteractionStressMalloc(FMalloc* InInnerMalloc);
+
+	static FInteractionStressMalloc& Get();
+
+	FMalloc* InnerMalloc = nullptr;
+
+	/** Only changed and read on the game thread */
+	int32 CountingScopesNum = 0;
+
+	int64 AllocationsNum = 0;
+
+	void CountAllocation();
+};
@@ -0,0 +1,38 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "InteractionStressTarget.h"
+
+#include "Components/SphereComponent.h"
+#include "Engine/CollisionProfile.h"
+
+AInteractionStressTarget::AInteractionStressTarget()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	CollisionComponent = CreateDefaultSubobject<USphereComponent>(TEXT("CollisionComponent"));
+	CollisionComponent->InitSphereRadius(50.f);
+	CollisionComponent->SetCollisionProfileName(UCollisionProfile::BlockAllDynamic_ProfileName);
+	SetRootComponent(CollisionComponent);
+}
+
+EInteractionResult AInteractionStressTarget::StartInteraction_Implementation(AActor* Interactor)
+{
+	return EInteractionResult::Success;
+}
+
+EInteractionResult AInteractionStressTarget::InterruptInteraction_Implementation(AActor* Interruptor,
+                                                                                 AActor* Interactor)
+{
+	return EInteractionResult::Success;
+}
+
+EInteractionResult AInteractionStressTarget::FinishInteraction_Implementation(AActor* Interactor)
+{
+	return EInteractionResult::Success;
+}
+
+EInteractionResult AInteractionStressTarget::ForceInteraction_Implementation(AActor* Interactor)
+{
+	return EInteractionResult::Success;
+}
@@ -0,0 +1,37 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "TrickyInteractionInterface.h"
+#include "InteractionStressTarget.generated.h"
+
+class USphereComponent;
+
+/**
+ * Interactive actor spawned by the stress commandlet
+ * Every interaction succeeds immediately, so only the cost of the interaction system is measured.
+ */
+UCLASS(NotPlaceable, Transient)
+class AInteractionStressTarget : public AActor, public ITrickyInteractionInterface
+{
+	GENERATED_BODY()
+
+public:
+	AInteractionStressTarget();
+
+	virtual EInteractionResult StartInteraction_Implementation(AActor* Interactor) override;
+
+	virtual EInteractionResult InterruptInteraction_Implementation(AActor* Interruptor, AActor* Interactor) override;
+
+	virtual EInteractionResult FinishInteraction_Implementation(AActor* Interactor) override;
+
+	virtual EInteractionResult ForceInteraction_Implementation(AActor* Interactor) override;
+
+	UPROPERTY(VisibleAnywhere, Category="InteractionStress")
+	TObjectPtr<USphereComponent> CollisionComponent = nullptr;
+
+	UPROPERTY(EditAnywhere, Category="InteractionStress")
+	FInteractionData InteractionData;
+};
@@ -0,0 +1,28 @@
+// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+using UnrealBuildTool;
+
+public class TrickyInteractionSystemEditor : ModuleRules
+{
+	public TrickyInteractionSystemEditor(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+			}
+			);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"CoreUObject",
+				"Engine",
+				"Json",
+				"TrickyInteractionSystem",
+			}
+			);
+	}
+}